@@ -27,6 +27,7 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
+#include <esp_err.h>
 
 #include <aws_iot_mqtt_client_interface.h>
 
@@ -48,11 +49,32 @@ void psq4_mqtt_subscribe(
 );
 
 
-// Note that this blocks until the message is published
-void psq4_mqtt_publish(
+// Called from the MQTT maintenance task once a publish has completed,
+// with SUCCESS or the IoT Error that it was abandoned with. Must not block.
+typedef void (*psq4_mqtt_publish_callback_t)(IoT_Error_t rc, void *arg);
+
+
+// Queues a message for the MQTT maintenance task to publish and returns
+// immediately. The topic and payload_len bytes of payload are copied. Messages are published
+// in the order queued, held while the connection is down, and retried a
+// few times on failure before being abandoned. Returns ESP_ERR_NO_MEM if
+// the outbound queue is full.
+esp_err_t psq4_mqtt_publish_async(
+    const char *topic,
+    enum QoS qos,
+    const void *payload,
+    size_t payload_len,
+    psq4_mqtt_publish_callback_t callback,
+    void *callback_arg
+);
+
+
+// Note that this blocks until the message is published or abandoned
+IoT_Error_t psq4_mqtt_publish(
     const char *topic,
     enum QoS qos,
-    const char *payload
+    const void *payload,
+    size_t payload_len
 );
 
 
@@ -24,15 +24,20 @@
 
 #include "psq4_aws_iot.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
 #include <freertos/event_groups.h>
 
 #include <esp_system.h>
 #include <esp_log.h>
 
+#include <lwip/sockets.h>
+#include <mbedtls/ssl.h>
+
 #include <aws_iot_config.h>
 #include <aws_iot_log.h>
 #include <aws_iot_version.h>
@@ -40,9 +45,46 @@
 
 #include <psq4_system.h>
 #include <psq4_constants.h>
+#include <psq4_retry.h>
+#include <psq4_rtos.h>
+#include <psq4_trace.h>
+
+// Operations waiting for the maintenance task
+#define PSQ4_MQTT_OUTBOUND_QUEUE_LENGTH 8
+// Publish attempts made while connected before a message is abandoned
+#define PSQ4_MQTT_PUBLISH_ATTEMPTS 5
+#define PSQ4_MQTT_KEEP_ALIVE_S 10
+// Longest the maintenance task sleeps between yields to the MQTT client,
+// often enough to keep the connection alive
+#define PSQ4_MQTT_IDLE_MS (PSQ4_MQTT_KEEP_ALIVE_S * 1000 / 4)
+// Time given to the MQTT client to read what the broker has sent
+#define PSQ4_MQTT_YIELD_MS 10
+// Delay before retrying a failed publish
+#define PSQ4_MQTT_RETRY_MS 100
 
 static const char *PSQ4_AWS_IOT_MQTT_CLIENT_TAG = "psq4-aws-iot-mqtt-client";
 
+static void connection_circuit_changed(bool open);
+
+// Connecting and reconnecting back off together, and rest for a while
+// once the broker has been unreachable for some time
+static const psq4_retry_policy_t connection_retry_policy = {
+    .base_ms = 1000,
+    .cap_ms = 60000,
+    .failure_threshold = 10,
+    .open_ms = 300000,
+    .on_open = connection_circuit_changed,
+};
+static psq4_retry_t connection_retry;
+
+// Subscribing only happens while connected
+static const psq4_retry_policy_t subscribe_retry_policy = {
+    .base_ms = 1000,
+    .cap_ms = 30000,
+    .failure_threshold = 0,
+    .open_ms = 0,
+};
+
 extern const uint8_t aws_root_ca_pem_start[] asm("_binary_aws_root_ca_pem_start");
 extern const uint8_t certificate_pem_crt_start[] asm("_binary_certificate_pem_crt_start");
 extern const uint8_t private_pem_key_start[] asm("_binary_private_pem_key_start");
@@ -51,9 +93,54 @@ extern const uint8_t private_pem_key_start[] asm("_binary_private_pem_key_start"
 static char mqtt_host_address[255] = AWS_IOT_MQTT_HOST;
 static uint32_t mqtt_host_port = AWS_IOT_MQTT_PORT;
 
+// Only the maintenance task uses the client, so calls into it never
+// contend. Other tasks queue operations for the maintenance task instead.
 static AWS_IoT_Client client;
 
 
+typedef enum {
+    PSQ4_MQTT_OP_PUBLISH,
+    PSQ4_MQTT_OP_SUBSCRIBE,
+} psq4_mqtt_op_kind_t;
+
+
+typedef struct {
+    psq4_mqtt_op_kind_t kind;
+    enum QoS qos;
+    // For publishes, a heap copy with the payload following it
+    const char *topic;
+    IoT_Publish_Message_Params params;
+    pApplicationHandler_t handler;
+    psq4_mqtt_publish_callback_t callback;
+    void *callback_arg;
+} psq4_mqtt_op_t;
+
+
+// Lets a task wait on an operation run by the maintenance task
+typedef struct {
+    TaskHandle_t task;
+    IoT_Error_t rc;
+} psq4_mqtt_waiter_t;
+
+
+static QueueHandle_t outbound_queue;
+
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+// Queued messages are copied into a fixed pool of buffers, each large
+// enough for anything the client can send
+#define PSQ4_MQTT_MESSAGE_POOL_SIZE 4
+static char message_pool[PSQ4_MQTT_MESSAGE_POOL_SIZE][CONFIG_AWS_IOT_MQTT_TX_BUF_LEN];
+static QueueHandle_t free_messages;
+#endif
+
+// The maintenance task sleeps in select() on the broker connection and a
+// loopback UDP socket, to which other tasks send a datagram after queueing
+// an operation
+static int wake_fd = -1;
+static int wake_sender_fd = -1;
+static struct sockaddr_in wake_addr;
+
+
 static void handle_message(
     AWS_IoT_Client *client,
     char *topic_name,
@@ -76,6 +163,17 @@ static void handle_message(
 }
 
 
+// Lets the rest of the system know when the broker is given a rest
+static void connection_circuit_changed(bool open)
+{
+    if (open) {
+        xEventGroupSetBits(psq4_system()->event_group, PSQ4_MQTT_CIRCUIT_OPEN_BIT);
+    } else {
+        xEventGroupClearBits(psq4_system()->event_group, PSQ4_MQTT_CIRCUIT_OPEN_BIT);
+    }
+}
+
+
 static void handle_disconnect(AWS_IoT_Client *client, void *ignored)
 {
     // The maintenance task will attempt to reconnect
@@ -91,10 +189,10 @@ static bool disconnected()
 }
 
 
-static void connect()
+static void mqtt_connect()
 {
     IoT_Client_Connect_Params connectParams = iotClientConnectParamsDefault;
-    connectParams.keepAliveIntervalInSec = 10;
+    connectParams.keepAliveIntervalInSec = PSQ4_MQTT_KEEP_ALIVE_S;
     connectParams.isCleanSession = true;
     connectParams.MQTTVersion = MQTT_3_1_1;
     connectParams.pClientID = CONFIG_AWS_IOT_THING_NAME;
@@ -117,9 +215,9 @@ static void connect()
                 mqtt_host_address,
                 mqtt_host_port
             );
-            // TODO: exponential backoff
-            vTaskDelay(1000 / portTICK_PERIOD_MS);
+            psq4_retry_backoff(&connection_retry);
         } else {
+            psq4_retry_succeeded(&connection_retry);
             xEventGroupSetBits(psq4_system()->event_group, PSQ4_MQTT_CONNECTED_BIT);
             xEventGroupClearBits(psq4_system()->event_group, PSQ4_MQTT_INITIALIZING_BIT);
             ESP_LOGI(
@@ -133,7 +231,7 @@ static void connect()
 }
 
 
-static void reconnect()
+static void mqtt_reconnect()
 {
     size_t attempt_num = 1;
     IoT_Error_t rc;
@@ -152,9 +250,9 @@ static void reconnect()
                 mqtt_host_address,
                 mqtt_host_port
             );
-            // TODO: exponential backoff
-            vTaskDelay(1000 / portTICK_PERIOD_MS);
+            psq4_retry_backoff(&connection_retry);
         } else {
+            psq4_retry_succeeded(&connection_retry);
             xEventGroupSetBits(psq4_system()->event_group, PSQ4_MQTT_CONNECTED_BIT);
             ESP_LOGI(
                 PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
@@ -167,6 +265,146 @@ static void reconnect()
 }
 
 
+static void open_wake_sockets()
+{
+    socklen_t addr_len = sizeof(wake_addr);
+    memset(&wake_addr, 0, sizeof(wake_addr));
+    wake_addr.sin_family = AF_INET;
+    wake_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    wake_addr.sin_port = 0;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int sender_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (
+        fd < 0 ||
+        sender_fd < 0 ||
+        bind(fd, (struct sockaddr *) &wake_addr, sizeof(wake_addr)) != 0 ||
+        getsockname(fd, (struct sockaddr *) &wake_addr, &addr_len) != 0
+       )
+    {
+        ESP_LOGE(PSQ4_AWS_IOT_MQTT_CLIENT_TAG, "FATAL: Failed to open MQTT wake sockets");
+        abort();
+    }
+    wake_sender_fd = sender_fd;
+    wake_fd = fd;
+}
+
+
+// Called by other tasks once they have queued an operation
+static void wake_maintenance_task()
+{
+    static const char wake = 0;
+    if (wake_fd < 0) return;
+    sendto(
+        wake_sender_fd,
+        &wake,
+        sizeof(wake),
+        MSG_DONTWAIT,
+        (struct sockaddr *) &wake_addr,
+        sizeof(wake_addr)
+    );
+}
+
+
+// Sleeps until the broker sends something, an operation is queued, or the
+// timeout elapses
+static void await_activity(uint32_t timeout_ms)
+{
+    TLSDataParams *tls = &client.networkStack.tlsDataParams;
+    // Data already decrypted by a previous read won't make the socket readable
+    if (!disconnected() && mbedtls_ssl_get_bytes_avail(&tls->ssl) > 0) return;
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(wake_fd, &readable);
+    int max_fd = wake_fd;
+    if (!disconnected() && tls->server_fd.fd >= 0) {
+        FD_SET(tls->server_fd.fd, &readable);
+        if (tls->server_fd.fd > max_fd) max_fd = tls->server_fd.fd;
+    }
+    struct timeval timeout = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    if (select(max_fd + 1, &readable, NULL, NULL, &timeout) > 0 && FD_ISSET(wake_fd, &readable)) {
+        char discarded[8];
+        while (recv(wake_fd, discarded, sizeof(discarded), MSG_DONTWAIT) > 0);
+    }
+}
+
+
+// Obtains a buffer for a queued message of len bytes, or NULL
+static char *message_alloc(size_t len, TickType_t ticks_to_wait)
+{
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    char *message = NULL;
+    if (len > CONFIG_AWS_IOT_MQTT_TX_BUF_LEN) return NULL;
+    xQueueReceive(free_messages, &message, ticks_to_wait);
+    return message;
+#else
+    return malloc(len);
+#endif
+}
+
+
+static void message_free(char *message)
+{
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    xQueueSendToBack(free_messages, &message, portMAX_DELAY);
+#else
+    free(message);
+#endif
+}
+
+
+static IoT_Error_t run_op(psq4_mqtt_op_t *op)
+{
+    IoT_Error_t rc;
+    if (op->kind == PSQ4_MQTT_OP_SUBSCRIBE) {
+        return aws_iot_mqtt_subscribe(
+            &client,
+            op->topic,
+            strlen(op->topic),
+            op->qos,
+            handle_message,
+            op->handler
+        );
+    }
+    // For QoS 1, this includes waiting for the PUBACK
+    PSQ4_TRACE_BEGIN("mqtt_publish");
+    rc = aws_iot_mqtt_publish(&client, op->topic, strlen(op->topic), &op->params);
+    PSQ4_TRACE_END("mqtt_publish");
+    if (SUCCESS != rc) {
+        ESP_LOGW(
+            PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
+            "MQTT publish to topic %s failed with IoT Error %d",
+            op->topic,
+            rc
+        );
+        xEventGroupSetBits(psq4_system()->event_group, PSQ4_MQTT_PUBLISH_FAILURE_BIT);
+    } else {
+        xEventGroupClearBits(psq4_system()->event_group, PSQ4_MQTT_PUBLISH_FAILURE_BIT);
+    }
+    return rc;
+}
+
+
+static void complete_op(psq4_mqtt_op_t *op, IoT_Error_t rc)
+{
+    if (op->kind == PSQ4_MQTT_OP_PUBLISH) {
+        if (SUCCESS != rc) {
+            ESP_LOGE(
+                PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
+                "Abandoned MQTT publish to topic %s with IoT Error %d",
+                op->topic,
+                rc
+            );
+        }
+        message_free((char *) op->topic);
+    }
+    if (op->callback) op->callback(rc, op->callback_arg);
+}
+
+
 // This task provides the CPU time needed to process
 // inbound messages and reconnect after disconnection
 static void mqtt_maintenance_task(void *ignored)
@@ -202,27 +440,69 @@ static void mqtt_maintenance_task(void *ignored)
         portMAX_DELAY
     );
 
+    open_wake_sockets();
+
     // Establishing the connection
-    connect();
+    mqtt_connect();
 
+    psq4_mqtt_op_t op;
+    bool op_held = false;
+    uint32_t op_attempts = 0;
     while (true) {
         // Reconnect if disconnected
         // This takes as long as it takes, but there's nothing else for
         // mqtt to do in the meantime, so this doesn't cannibalize time
-        // needed by the mqtt system
-        if (disconnected()) reconnect();
+        // needed by the mqtt system. A held publish gets a full set of
+        // attempts on the new connection, however many the old one took.
+        if (disconnected()) {
+            mqtt_reconnect();
+            op_attempts = 0;
+        }
+
+        // Run queued operations, oldest first, until one has to wait
+        // for the connection to come back
+        while (op_held || xQueueReceive(outbound_queue, &op, 0) == pdTRUE) {
+            op_held = false;
+            op_attempts++;
+            rc = run_op(&op);
+            // Subscribers retry for themselves
+            if (
+                SUCCESS != rc &&
+                op.kind == PSQ4_MQTT_OP_PUBLISH &&
+                (disconnected() || op_attempts < PSQ4_MQTT_PUBLISH_ATTEMPTS)
+               )
+            {
+                op_held = true;
+                break;
+            }
+            complete_op(&op, rc);
+            op_attempts = 0;
+        }
 
         // Yield CPU time to the MQTT client
-        aws_iot_mqtt_yield(&client, 100);
+        aws_iot_mqtt_yield(&client, PSQ4_MQTT_YIELD_MS);
 
-        vTaskDelay(500.0 / portTICK_PERIOD_MS);
+        // Sleep until there's more to do
+        await_activity(op_held ? PSQ4_MQTT_RETRY_MS : PSQ4_MQTT_IDLE_MS);
     }
 }
 
 
 void psq4_mqtt_init()
 {
-    xTaskCreatePinnedToCore(
+    psq4_retry_init(&connection_retry, &connection_retry_policy);
+    outbound_queue = PSQ4_QUEUE_CREATE(PSQ4_MQTT_OUTBOUND_QUEUE_LENGTH, sizeof(psq4_mqtt_op_t));
+    if (outbound_queue == NULL) {
+        ESP_LOGE(PSQ4_AWS_IOT_MQTT_CLIENT_TAG, "FATAL: Failed to create MQTT outbound queue");
+        abort();
+    }
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    free_messages = PSQ4_QUEUE_CREATE(PSQ4_MQTT_MESSAGE_POOL_SIZE, sizeof(char *));
+    for (size_t i = 0; i < PSQ4_MQTT_MESSAGE_POOL_SIZE; i++) {
+        message_free(message_pool[i]);
+    }
+#endif
+    PSQ4_TASK_CREATE_PINNED(
         &mqtt_maintenance_task,
         "mqttMaintenanceTask",
         9216,
@@ -234,6 +514,27 @@ void psq4_mqtt_init()
 }
 
 
+static void wake_waiter(IoT_Error_t rc, void *arg)
+{
+    psq4_mqtt_waiter_t *waiter = (psq4_mqtt_waiter_t *) arg;
+    waiter->rc = rc;
+    xTaskNotifyGive(waiter->task);
+}
+
+
+// Queues an operation and blocks until the maintenance task has run it
+static IoT_Error_t run_op_and_wait(psq4_mqtt_op_t *op)
+{
+    psq4_mqtt_waiter_t waiter = { xTaskGetCurrentTaskHandle(), FAILURE };
+    op->callback = wake_waiter;
+    op->callback_arg = &waiter;
+    xQueueSendToBack(outbound_queue, op, portMAX_DELAY);
+    wake_maintenance_task();
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return waiter.rc;
+}
+
+
 void psq4_mqtt_subscribe(
     const char *topic,
     enum QoS qos,
@@ -242,6 +543,8 @@ void psq4_mqtt_subscribe(
     EventBits_t connectedEventBit)
 {
     xEventGroupClearBits(psq4_system()->event_group, connectedEventBit);
+    psq4_retry_t subscribe_retry;
+    psq4_retry_init(&subscribe_retry, &subscribe_retry_policy);
     size_t attempt_num = 1;
     IoT_Error_t rc;
     do {
@@ -259,14 +562,14 @@ void psq4_mqtt_subscribe(
             qos,
             attempt_num++
         );
-        rc = aws_iot_mqtt_subscribe(
-            &client,
-            topic,
-            strlen(topic),
-            qos,
-            handle_message,
-            handler
-        );
+        // The client keeps the topic, so it isn't copied
+        psq4_mqtt_op_t op = {
+            .kind = PSQ4_MQTT_OP_SUBSCRIBE,
+            .qos = qos,
+            .topic = topic,
+            .handler = handler,
+        };
+        rc = run_op_and_wait(&op);
         if (SUCCESS != rc) {
             ESP_LOGW(
                 PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
@@ -275,8 +578,7 @@ void psq4_mqtt_subscribe(
                 topic
             );
             xEventGroupClearBits(psq4_system()->event_group, initializingEventBit);
-            // TODO: exponential backoff
-            vTaskDelay(1000 / portTICK_PERIOD_MS);
+            psq4_retry_backoff(&subscribe_retry);
         } else {
             xEventGroupSetBits(psq4_system()->event_group, connectedEventBit);
             xEventGroupClearBits(psq4_system()->event_group, initializingEventBit);
@@ -291,55 +593,69 @@ void psq4_mqtt_subscribe(
 }
 
 
-void psq4_mqtt_publish(
+// Builds a publish operation owning copies of the topic and payload
+static bool make_publish_op(
+    psq4_mqtt_op_t *op,
     const char *topic,
     enum QoS qos,
-    const char *payload
-) {
-    IoT_Publish_Message_Params params;
-    params.payload = (void *) payload;
-    params.payloadLen = strlen(payload);
-    params.qos = qos;
-    params.isRetained = 0;
-    uint32_t attempt_num = 1;
-    IoT_Error_t rc = FAILURE;
-    while (SUCCESS != rc) {
-        xEventGroupWaitBits(
-            psq4_system()->event_group,
-            PSQ4_MQTT_CONNECTED_BIT,
-            false,
-            true,
-            portMAX_DELAY
-        );
-        rc = aws_iot_mqtt_publish(&client, topic, strlen(topic), &params);
-        attempt_num++;
-        if (MQTT_CLIENT_NOT_IDLE_ERROR == rc) {
-            if (attempt_num % 100 == 0) {
-                ESP_LOGW(
-                    PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
-                    "MQTT publish to topic %s is failing (attempt #%d) because the MQTT client is not idle",
-                    topic,
-                    attempt_num
-                );
-            }
-            vTaskDelay(5.0 / portTICK_PERIOD_MS);
-        } else if (SUCCESS != rc) {
-            ESP_LOGW(
-                PSQ4_AWS_IOT_MQTT_CLIENT_TAG,
-                "MQTT publish to topic %s failed on attempt #%d with IoT Error %d",
-                topic,
-                attempt_num,
-                rc
-            );
-            xEventGroupSetBits(
-                psq4_system()->event_group,
-                PSQ4_MQTT_PUBLISH_FAILURE_BIT
-            );
-        } else {
-            xEventGroupClearBits(
-                psq4_system()->event_group,
-                PSQ4_MQTT_PUBLISH_FAILURE_BIT
-            );
-        }
+    const void *payload,
+    size_t payload_len,
+    TickType_t ticks_to_wait)
+{
+    size_t topic_len = strlen(topic);
+    char *copy = message_alloc(topic_len + 1 + payload_len, ticks_to_wait);
+    if (copy == NULL) return false;
+    memcpy(copy, topic, topic_len + 1);
+    memcpy(copy + topic_len + 1, payload, payload_len);
+    memset(op, 0, sizeof(psq4_mqtt_op_t));
+    op->kind = PSQ4_MQTT_OP_PUBLISH;
+    op->qos = qos;
+    op->topic = copy;
+    op->params.payload = copy + topic_len + 1;
+    op->params.payloadLen = payload_len;
+    op->params.qos = qos;
+    op->params.isRetained = 0;
+    return true;
+}
+
+
+esp_err_t psq4_mqtt_publish_async(
+    const char *topic,
+    enum QoS qos,
+    const void *payload,
+    size_t payload_len,
+    psq4_mqtt_publish_callback_t callback,
+    void *callback_arg)
+{
+    psq4_mqtt_op_t op;
+    if (!make_publish_op(&op, topic, qos, payload, payload_len, 0)) return ESP_ERR_NO_MEM;
+    op.callback = callback;
+    op.callback_arg = callback_arg;
+    if (xQueueSendToBack(outbound_queue, &op, 0) != pdTRUE) {
+        message_free((char *) op.topic);
+        return ESP_ERR_NO_MEM;
+    }
+    wake_maintenance_task();
+    return ESP_OK;
+}
+
+
+IoT_Error_t psq4_mqtt_publish(
+    const char *topic,
+    enum QoS qos,
+    const void *payload,
+    size_t payload_len)
+{
+    psq4_mqtt_op_t op;
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    if (strlen(topic) + 1 + payload_len > CONFIG_AWS_IOT_MQTT_TX_BUF_LEN) {
+        ESP_LOGE(PSQ4_AWS_IOT_MQTT_CLIENT_TAG, "MQTT message for topic %s is too large to publish", topic);
+        return MQTT_TX_BUFFER_TOO_SHORT_ERROR;
+    }
+#endif
+    while (!make_publish_op(&op, topic, qos, payload, payload_len, 1000 / portTICK_PERIOD_MS)) {
+        ESP_LOGW(PSQ4_AWS_IOT_MQTT_CLIENT_TAG, "Out of memory for MQTT publish to topic %s", topic);
+        vTaskDelay(1000 / portTICK_PERIOD_MS);
     }
+    return run_op_and_wait(&op);
 }
@@ -25,6 +25,11 @@
 #ifndef PSQ4_GFX_H
 #define PSQ4_GFX_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sdkconfig.h>
+#include <esp_err.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
@@ -38,6 +43,16 @@ extern "C" {
 // library for prototyping purposes only.
 
 
+/**
+ * @brief Maximum number of dirty regions tracked per canvas
+ *
+ * When more regions than this are dirtied between
+ * flushes, the pair whose union is cheapest to flush
+ * is merged to make room.
+ */
+#define PSQ4_GFX_MAX_DIRTY_RECTS 8
+
+
 /**
  * @brief 2D dimensions - width and height
  *
@@ -83,6 +98,43 @@ typedef struct {
 } psq4_gfx_sprite_t;
 
 
+/**
+ * @brief Run opcodes for run-length encoded sprites
+ *
+ * Each run starts with a header byte holding one of
+ * these opcodes in its upper two bits and the run
+ * length, minus one, in its lower six bits.
+ *
+ * SKIP runs leave the canvas untouched (transparent)
+ * and carry no payload. FILL runs are followed by a
+ * single big-endian RGB/565 color that is repeated
+ * for the length of the run. COPY runs are followed
+ * by one big-endian RGB/565 color per pixel.
+ */
+#define PSQ4_GFX_RLE_SKIP       0x00
+#define PSQ4_GFX_RLE_FILL       0x40
+#define PSQ4_GFX_RLE_COPY       0x80
+#define PSQ4_GFX_RLE_OP_MASK    0xC0
+#define PSQ4_GFX_RLE_LEN_MASK   0x3F
+#define PSQ4_GFX_RLE_MAX_RUN    64
+
+
+/**
+ * @brief A run-length encoded sprite
+ *
+ * The data is a sequence of runs (see PSQ4_GFX_RLE_*),
+ * row by row from the top. Runs never span rows, and
+ * the runs of each row add up to exactly dim.w pixels.
+ *
+ * Sprite sources are generated from PNG images by
+ * tools/psq4_sprite.py.
+ */
+typedef struct {
+    const uint8_t *data;
+    psq4_gfx_dim_t dim;
+} psq4_gfx_rle_sprite_t;
+
+
 /**
  * @brief 2D in-memory graphics canvas
  *
@@ -110,26 +162,28 @@ typedef struct {
      * display.
      */
     SemaphoreHandle_t updates;
-    /**
-     * @brief The coordinate of the next row to
-     * consider for flushing to the display.
-     */
-    size_t dirty_row_cursor;
     /** @brief Number of bytes per row */
     size_t row_size_bytes;
     /**
-     * @brief Number of rows that contain updates
+     * @brief Number of regions that contain updates
      */
-    size_t dirty_row_count;
+    size_t dirty_rect_count;
     /**
-     * @brief Indicates which rows contain updates
+     * @brief Regions that contain updates
      *
-     * Array of booleans indexed by row coordinate,
-     * each true only if the row with that coordinate
-     * contains updates that need to be flushed to
-     * the display.
+     * Each entry bounds a rectangle of the canvas that
+     * needs to be flushed to the display, oldest first.
+     * Overlapping regions and regions that would be no
+     * more expensive to flush together than apart are
+     * merged as they are marked dirty.
      */
-    bool *dirty_rows;
+    psq4_gfx_bounds_t dirty_rects[PSQ4_GFX_MAX_DIRTY_RECTS];
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    /** @brief storage for mutex */
+    StaticSemaphore_t mutex_buffer;
+    /** @brief storage for updates */
+    StaticSemaphore_t updates_buffer;
+#endif
 } psq4_gfx_canvas_t;
 
 
@@ -150,11 +204,25 @@ esp_err_t psq4_gfx_init(
 );
 
 
+/**
+ * @brief Release the memory held by a canvas
+ *
+ * The canvas must not be in use by any other task.
+ *
+ * @param canvas the canvas to release
+ */
+void psq4_gfx_free(psq4_gfx_canvas_t *canvas);
+
+
 /**
  * @brief Flushes updates to a buffer
  *
- * Copies as many contiguous rows with updates as
- * possible to the provided buffer.
+ * Copies as many rows of the oldest dirty region as
+ * possible to the provided buffer. Only the columns
+ * spanned by that region are copied, so the buffer
+ * holds a block of (x1 - x0 + 1) x (y1 - y0 + 1)
+ * pixels suitable for a column-windowed write to the
+ * display.
  *
  * @param canvas The canvas to flush
  * @param buffer The buffer into which the canvas
@@ -264,6 +332,93 @@ esp_err_t psq4_gfx_render_sprite(
 );
 
 
+/**
+ * @brief Renders a sprite over the existing canvas
+ *
+ * Like psq4_gfx_render_sprite(..), except that sprite
+ * pixels matching the key color are transparent and
+ * leave the underlying canvas pixels in place.
+ *
+ * @param canvas The canvas to paint on
+ * @param sprite The sprite's image data
+ * @param key The big-endian RGB/565 color that is
+ *        treated as transparent
+ * @param origin The coordinates on the canvas where
+ *        the top left-most pixel of the sprite will
+ *        be rendered
+ * @param bounds The bounds of the sprite as rendered,
+ *        set by this function
+ * @return ESP_OK if everything went well, otherwise
+ *         an error indicating what went wrong.
+ */
+esp_err_t psq4_gfx_render_sprite_keyed(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_sprite_t *sprite,
+    uint16_t key,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds
+);
+
+
+/**
+ * @brief Renders a run-length encoded sprite
+ *
+ * Runs are written straight to the canvas without
+ * being decoded into an intermediate buffer. SKIP
+ * runs leave the underlying canvas pixels in place.
+ *
+ * So long as the origin is on the canvas, any portion
+ * of the sprite that extends beyond the canvas is
+ * simply truncated.
+ *
+ * @param canvas The canvas to paint on
+ * @param sprite The sprite's encoded image data
+ * @param origin The coordinates on the canvas where
+ *        the top left-most pixel of the sprite will
+ *        be rendered
+ * @param bounds The bounds of the sprite as rendered,
+ *        set by this function
+ * @return ESP_OK if everything went well, otherwise
+ *         an error indicating what went wrong.
+ */
+esp_err_t psq4_gfx_render_rle_sprite(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_rle_sprite_t *sprite,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds
+);
+
+
+/**
+ * @brief Erases a run-length encoded sprite
+ *
+ * Uses the sprite as a 1-bit mask: every pixel that
+ * the sprite would paint is set to a single color,
+ * while pixels under SKIP runs are left untouched.
+ * Erasing a transparent sprite with the background
+ * color it was drawn over removes it without
+ * disturbing anything else in its bounds.
+ *
+ * @param canvas The canvas to paint on
+ * @param sprite The sprite's encoded image data
+ * @param color The big-endian RGB/565 color to paint
+ * @param origin The coordinates on the canvas where
+ *        the top left-most pixel of the sprite was
+ *        rendered
+ * @param bounds The bounds of the sprite as erased,
+ *        set by this function
+ * @return ESP_OK if everything went well, otherwise
+ *         an error indicating what went wrong.
+ */
+esp_err_t psq4_gfx_erase_rle_sprite(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_rle_sprite_t *sprite,
+    uint16_t color,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds
+);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_GFX_BENCH_H
+#define PSQ4_GFX_BENCH_H
+
+#include <esp_err.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Benchmark drawing and flushing, printing results to stdout
+ *
+ * Runs a series of scenarios on a display-sized canvas of its own,
+ * flushing after each frame as the UI does, and reports per scenario:
+ * drawing and flushing time per pixel, the bytes flushed per frame,
+ * flush chunks per frame, and overdraw (pixels flushed per pixel
+ * drawn). Then compares the fill rate of psq4_gfx_fill_rect() with
+ * that of the per-pixel loop that its row-span kernels replaced.
+ * Builds for the device and for the host (see host/).
+ *
+ * @return ESP_ERR_NO_MEM if the canvas couldn't be allocated
+ */
+esp_err_t psq4_gfx_bench_run();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_GFX_BENCH_H
@@ -23,33 +23,60 @@
  */
 
 #include "psq4_gfx.h"
+#include <stdlib.h>
 #include <string.h>
 #include <esp_log.h>
+#include <esp_system.h>
 
 
 static const char * PSQ4_GFX_TAG = "psq4-gfx";
 
 
+// Fills n contiguous pixels with a single color, two pixels per
+// 32-bit store once dst is word aligned
+static void psq4_gfx__fill_span(
+    uint16_t *dst,
+    uint16_t color,
+    size_t n)
+{
+    if (n == 0) return;
+    if (((uintptr_t) dst & 0x3) != 0) {
+        *dst++ = color;
+        n--;
+    }
+    uint32_t word = ((uint32_t) color << 16) | color;
+    uint32_t *dst32 = (uint32_t *) dst;
+    for (size_t i = n >> 1; i > 0; i--) {
+        *dst32++ = word;
+    }
+    if (n & 0x1) {
+        *((uint16_t *) dst32) = color;
+    }
+}
+
+
 esp_err_t psq4_gfx_init(
     psq4_gfx_canvas_t *canvas,
     psq4_gfx_dim_t *dim)
 {
     canvas->dim = *dim;
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+    canvas->mutex = xSemaphoreCreateMutexStatic(&canvas->mutex_buffer);
+    canvas->updates = xSemaphoreCreateBinaryStatic(&canvas->updates_buffer);
+#else
     canvas->mutex = xSemaphoreCreateMutex();
     canvas->updates = xSemaphoreCreateBinary();
+#endif
     if (!canvas->mutex || !canvas->updates) {
         ESP_LOGE(PSQ4_GFX_TAG, "Unable to allocate semaphores");
         return ESP_ERR_NO_MEM;
     }
-    canvas->dirty_row_cursor = 0;
     canvas->row_size_bytes = dim->w * 2;
-    canvas->dirty_row_count = dim->h;
-    canvas->dirty_rows = (bool *) calloc(dim->h, sizeof(bool));
-    if (!canvas->dirty_rows) {
-        ESP_LOGE(PSQ4_GFX_TAG, "Unable to allocate dirty rows array");
-        return ESP_ERR_NO_MEM;
-    }
-    for (size_t i = 0; i < dim->h; i++) canvas->dirty_rows[i] = true;
+    canvas->dirty_rect_count = 1;
+    canvas->dirty_rects[0].x0 = 0;
+    canvas->dirty_rects[0].y0 = 0;
+    canvas->dirty_rects[0].x1 = dim->w - 1;
+    canvas->dirty_rects[0].y1 = dim->h - 1;
     canvas->data = (uint16_t *) calloc(dim->w * dim->h, sizeof(uint16_t));
     if (!canvas->data) {
         ESP_LOGE(PSQ4_GFX_TAG, "Unable to allocate canvas data buffer");
@@ -61,40 +88,64 @@ esp_err_t psq4_gfx_init(
 }
 
 
-void psq4_gfx__flush(
+void psq4_gfx_free(psq4_gfx_canvas_t *canvas)
+{
+    free(canvas->data);
+    canvas->data = NULL;
+    vSemaphoreDelete(canvas->updates);
+    vSemaphoreDelete(canvas->mutex);
+    canvas->updates = NULL;
+    canvas->mutex = NULL;
+}
+
+
+static void psq4_gfx__remove_dirty_rect(
+    psq4_gfx_canvas_t *canvas,
+    size_t i)
+{
+    canvas->dirty_rect_count--;
+    memmove(
+        &canvas->dirty_rects[i],
+        &canvas->dirty_rects[i + 1],
+        (canvas->dirty_rect_count - i) * sizeof(psq4_gfx_bounds_t)
+    );
+}
+
+
+static void psq4_gfx__flush(
     psq4_gfx_canvas_t *canvas,
     void *buffer,
     size_t max_len_bytes,
     psq4_gfx_bounds_t *bounds,
     size_t *len_bytes)
 {
-    if (canvas->dirty_row_count == 0) return;
-    size_t capacity = max_len_bytes / canvas->row_size_bytes;
-    bounds->x0 = 0;
-    bounds->x1 = canvas->dim.w - 1;
-    // Advance to the first dirty row (we know there is one)
-    while (!canvas->dirty_rows[canvas->dirty_row_cursor]) {
-        canvas->dirty_row_cursor = (canvas->dirty_row_cursor + 1) % canvas->dim.h;
-    }
-    bounds->y0 = canvas->dirty_row_cursor;
+    if (canvas->dirty_rect_count == 0) return;
+    psq4_gfx_bounds_t *rect = &canvas->dirty_rects[0];
+    size_t width = rect->x1 - rect->x0 + 1;
+    size_t row_len_bytes = width * sizeof(uint16_t);
+    size_t capacity = max_len_bytes / row_len_bytes;
+    bounds->x0 = rect->x0;
+    bounds->x1 = rect->x1;
+    bounds->y0 = rect->y0;
     size_t src_cursor;
     size_t dst_cursor = 0;
     *len_bytes = 0;
-    // Terminate when we reach a clean row or fill the capacity of the buffer
-    while(canvas->dirty_rows[canvas->dirty_row_cursor] && capacity > 0) {
-        src_cursor = canvas->dirty_row_cursor * canvas->row_size_bytes;
-        memcpy(&(((uint8_t *)buffer)[dst_cursor]), &(((uint8_t *)(canvas->data))[src_cursor]), canvas->row_size_bytes);
-        *len_bytes += canvas->row_size_bytes;
-        canvas->dirty_rows[canvas->dirty_row_cursor] = false;
-        bounds->y1 = canvas->dirty_row_cursor;
-        canvas->dirty_row_count = canvas->dirty_row_count - 1;
+    // Terminate when we exhaust the region or fill the capacity of the buffer
+    size_t y = rect->y0;
+    while (y <= rect->y1 && capacity > 0) {
+        src_cursor = (y * canvas->dim.w) + rect->x0;
+        memcpy(&(((uint8_t *)buffer)[dst_cursor]), &(canvas->data[src_cursor]), row_len_bytes);
+        *len_bytes += row_len_bytes;
+        dst_cursor += row_len_bytes;
         capacity--;
-        dst_cursor += canvas->row_size_bytes;
-        canvas->dirty_row_cursor = canvas->dirty_row_cursor + 1;
-        if (canvas->dirty_row_cursor == canvas->dim.h) {
-            canvas->dirty_row_cursor = 0;
-            break;
-        }
+        y++;
+    }
+    bounds->y1 = y - 1;
+    if (y > rect->y1) {
+        // The region is fully flushed, so retire it
+        psq4_gfx__remove_dirty_rect(canvas, 0);
+    } else {
+        rect->y0 = y;
     }
 }
 
@@ -115,10 +166,10 @@ esp_err_t psq4_gfx_flush(
     }
     if (xSemaphoreTake(canvas->updates, portMAX_DELAY) == pdTRUE) {
         if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
-            if (canvas->dirty_row_count > 0) {
+            if (canvas->dirty_rect_count > 0) {
                 psq4_gfx__flush(canvas, buffer, max_len_bytes, bounds, len_bytes);
             }
-            if (canvas->dirty_row_count > 0) {
+            if (canvas->dirty_rect_count > 0) {
                 xSemaphoreGive(canvas->updates);
             }
             xSemaphoreGive(canvas->mutex);
@@ -134,25 +185,76 @@ esp_err_t psq4_gfx_flush(
 }
 
 
-static void psq4_gfx__dirty_row(
-    psq4_gfx_canvas_t *canvas,
-    uint8_t y)
+static uint32_t psq4_gfx__area(const psq4_gfx_bounds_t *bounds)
 {
-    if (!canvas->dirty_rows[y]) {
-        canvas->dirty_rows[y] = true;
-        canvas->dirty_row_count++;
-        xSemaphoreGive(canvas->updates);
-    }
+    return (uint32_t) (bounds->x1 - bounds->x0 + 1) * (bounds->y1 - bounds->y0 + 1);
+}
+
+
+static void psq4_gfx__union(
+    const psq4_gfx_bounds_t *a,
+    const psq4_gfx_bounds_t *b,
+    psq4_gfx_bounds_t *u)
+{
+    u->x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+    u->y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+    u->x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    u->y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+}
+
+
+// Extra area flushed if a and b are merged instead of flushed separately.
+// Zero or less means that merging costs nothing.
+static int32_t psq4_gfx__merge_cost(
+    const psq4_gfx_bounds_t *a,
+    const psq4_gfx_bounds_t *b)
+{
+    psq4_gfx_bounds_t u;
+    psq4_gfx__union(a, b, &u);
+    return (int32_t) psq4_gfx__area(&u) - psq4_gfx__area(a) - psq4_gfx__area(b);
 }
 
 
 static void psq4_gfx__dirty_bounds(
     psq4_gfx_canvas_t *canvas,
-    psq4_gfx_bounds_t *bounds)
+    const psq4_gfx_bounds_t *bounds)
 {
-    for (size_t y = bounds->y0; y <= bounds->y1; y++) {
-        psq4_gfx__dirty_row(canvas, y);
+    psq4_gfx_bounds_t rect = *bounds;
+    bool merged;
+
+    // Absorb every region that is free to merge with; each merge grows
+    // the rect, which may make further merges free, so repeat until stable
+    do {
+        merged = false;
+        for (size_t i = 0; i < canvas->dirty_rect_count; i++) {
+            if (psq4_gfx__merge_cost(&rect, &canvas->dirty_rects[i]) <= 0) {
+                psq4_gfx__union(&rect, &canvas->dirty_rects[i], &rect);
+                psq4_gfx__remove_dirty_rect(canvas, i);
+                merged = true;
+                break;
+            }
+        }
+    } while (merged);
+
+    if (canvas->dirty_rect_count == PSQ4_GFX_MAX_DIRTY_RECTS) {
+        // Out of room; fold the rect into the region that it is cheapest
+        // to merge with
+        size_t best = 0;
+        int32_t best_cost = psq4_gfx__merge_cost(&rect, &canvas->dirty_rects[0]);
+        for (size_t i = 1; i < canvas->dirty_rect_count; i++) {
+            int32_t cost = psq4_gfx__merge_cost(&rect, &canvas->dirty_rects[i]);
+            if (cost < best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+        psq4_gfx__union(&rect, &canvas->dirty_rects[best], &rect);
+        psq4_gfx__remove_dirty_rect(canvas, best);
     }
+
+    canvas->dirty_rects[canvas->dirty_rect_count] = rect;
+    canvas->dirty_rect_count++;
+    xSemaphoreGive(canvas->updates);
 }
 
 
@@ -213,7 +315,8 @@ esp_err_t psq4_gfx_fill_px(
     if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
         j = (coords->y * canvas->dim.w) + coords->x;
         canvas->data[j] = color;
-        psq4_gfx__dirty_row(canvas, coords->y);
+        psq4_gfx_bounds_t px_bounds = { coords->x, coords->y, coords->x, coords->y };
+        psq4_gfx__dirty_bounds(canvas, &px_bounds);
         xSemaphoreGive(canvas->mutex);
         return ESP_OK;
     } else {
@@ -240,11 +343,16 @@ esp_err_t psq4_gfx_fill_rect(
         return ESP_ERR_INVALID_ARG;
     }
     if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
-        size_t j;
-        for (uint8_t y = bounds->y0; y <= bounds->y1; y++) {
-            for (uint8_t x = bounds->x0; x <= bounds->x1; x++) {
-                j = (y * canvas->dim.w) + x;
-                canvas->data[j] = color;
+        size_t width = bounds->x1 - bounds->x0 + 1;
+        size_t height = bounds->y1 - bounds->y0 + 1;
+        uint16_t *dst = &canvas->data[(bounds->y0 * canvas->dim.w) + bounds->x0];
+        if (width == canvas->dim.w) {
+            // Full-width rows are contiguous, so fill them in one pass
+            psq4_gfx__fill_span(dst, color, width * height);
+        } else {
+            for (size_t y = 0; y < height; y++) {
+                psq4_gfx__fill_span(dst, color, width);
+                dst += canvas->dim.w;
             }
         }
         psq4_gfx__dirty_bounds(canvas, bounds);
@@ -280,16 +388,13 @@ esp_err_t psq4_gfx_render_sprite(
         return ret;
     }
     if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
-        size_t src, dst;
-        uint8_t src_row = 0;
+        size_t row_len_bytes = (bounds->x1 - bounds->x0 + 1) * sizeof(uint16_t);
+        const uint16_t *src = sprite->data;
+        uint16_t *dst = &canvas->data[(bounds->y0 * canvas->dim.w) + bounds->x0];
         for (uint8_t y = bounds->y0; y <= bounds->y1; y++) {
-            src = src_row * sprite->dim.w;
-            for (uint8_t x = bounds->x0; x <= bounds->x1; x++) {
-                dst = (y * canvas->dim.w) + x;
-                canvas->data[dst] = sprite->data[src];
-                src++;
-            }
-            src_row++;
+            memcpy(dst, src, row_len_bytes);
+            src += sprite->dim.w;
+            dst += canvas->dim.w;
         }
         psq4_gfx__dirty_bounds(canvas, bounds);
         xSemaphoreGive(canvas->mutex);
@@ -302,3 +407,148 @@ esp_err_t psq4_gfx_render_sprite(
     }
     return ESP_OK;
 }
+
+
+esp_err_t psq4_gfx_render_sprite_keyed(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_sprite_t *sprite,
+    uint16_t key,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds)
+{
+    esp_err_t ret;
+    bounds->x0 = origin->x;
+    bounds->y0 = origin->y;
+    bounds->x1 = bounds->x0 + sprite->dim.w - 1;
+    bounds->y1 = bounds->y0 + sprite->dim.h - 1;
+    ret = psq4_gfx_constrain(canvas, bounds);
+    if (ret != ESP_OK) {
+        ESP_LOGE(
+            PSQ4_GFX_TAG,
+            "Invalid origin provided to psq4_gfx_render_sprite_keyed(...)"
+        );
+        return ret;
+    }
+    if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
+        size_t visible = bounds->x1 - bounds->x0 + 1;
+        const uint16_t *src = sprite->data;
+        uint16_t *dst = &canvas->data[(bounds->y0 * canvas->dim.w) + bounds->x0];
+        for (uint8_t y = bounds->y0; y <= bounds->y1; y++) {
+            for (size_t x = 0; x < visible; x++) {
+                if (src[x] != key) dst[x] = src[x];
+            }
+            src += sprite->dim.w;
+            dst += canvas->dim.w;
+        }
+        psq4_gfx__dirty_bounds(canvas, bounds);
+        xSemaphoreGive(canvas->mutex);
+    } else {
+        ESP_LOGE(
+            PSQ4_GFX_TAG,
+            "psq4_gfx_render_sprite_keyed failed to acquire gfx semaphore"
+        );
+        esp_restart();
+    }
+    return ESP_OK;
+}
+
+
+// Writes one row of runs to dst, clipping to the first `visible` pixels,
+// and returns a pointer to the first run of the next row. If mask_color
+// is given, every opaque pixel is painted with it instead of its own color.
+static const uint8_t * psq4_gfx__blit_rle_row(
+    const uint8_t *src,
+    uint16_t *dst,
+    size_t width,
+    size_t visible,
+    const uint16_t *mask_color)
+{
+    size_t x = 0;
+    while (x < width) {
+        uint8_t op = *src & PSQ4_GFX_RLE_OP_MASK;
+        size_t len = (*src & PSQ4_GFX_RLE_LEN_MASK) + 1;
+        src++;
+        // Number of pixels in this run that land on the canvas
+        size_t n = x >= visible ? 0 : (x + len > visible ? visible - x : len);
+        const uint8_t *color = (const uint8_t *) mask_color;
+        if (op == PSQ4_GFX_RLE_FILL) {
+            if (!color) color = src;
+            src += sizeof(uint16_t);
+        } else if (op == PSQ4_GFX_RLE_COPY) {
+            if (!color && n > 0) memcpy(&dst[x], src, n * sizeof(uint16_t));
+            src += len * sizeof(uint16_t);
+        } else {
+            color = NULL;
+            n = 0;
+        }
+        if (color && n > 0) {
+            uint16_t fill;
+            memcpy(&fill, color, sizeof(uint16_t));
+            psq4_gfx__fill_span(&dst[x], fill, n);
+        }
+        x += len;
+    }
+    return src;
+}
+
+
+static esp_err_t psq4_gfx__render_rle_sprite(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_rle_sprite_t *sprite,
+    const uint16_t *mask_color,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds)
+{
+    esp_err_t ret;
+    bounds->x0 = origin->x;
+    bounds->y0 = origin->y;
+    bounds->x1 = bounds->x0 + sprite->dim.w - 1;
+    bounds->y1 = bounds->y0 + sprite->dim.h - 1;
+    ret = psq4_gfx_constrain(canvas, bounds);
+    if (ret != ESP_OK) {
+        ESP_LOGE(
+            PSQ4_GFX_TAG,
+            "Invalid origin provided to psq4_gfx_render_rle_sprite(...)"
+        );
+        return ret;
+    }
+    if (xSemaphoreTake(canvas->mutex, portMAX_DELAY) == pdTRUE) {
+        size_t visible = bounds->x1 - bounds->x0 + 1;
+        const uint8_t *src = sprite->data;
+        uint16_t *dst = &canvas->data[(bounds->y0 * canvas->dim.w) + bounds->x0];
+        for (uint8_t y = bounds->y0; y <= bounds->y1; y++) {
+            src = psq4_gfx__blit_rle_row(src, dst, sprite->dim.w, visible, mask_color);
+            dst += canvas->dim.w;
+        }
+        psq4_gfx__dirty_bounds(canvas, bounds);
+        xSemaphoreGive(canvas->mutex);
+    } else {
+        ESP_LOGE(
+            PSQ4_GFX_TAG,
+            "psq4_gfx_render_rle_sprite failed to acquire gfx semaphore"
+        );
+        esp_restart();
+    }
+    return ESP_OK;
+}
+
+
+esp_err_t psq4_gfx_render_rle_sprite(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_rle_sprite_t *sprite,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds)
+{
+    return psq4_gfx__render_rle_sprite(canvas, sprite, NULL, origin, bounds);
+}
+
+
+esp_err_t psq4_gfx_erase_rle_sprite(
+    psq4_gfx_canvas_t *canvas,
+    const psq4_gfx_rle_sprite_t *sprite,
+    uint16_t color,
+    const psq4_gfx_coords_t *origin,
+    psq4_gfx_bounds_t *bounds)
+{
+    return psq4_gfx__render_rle_sprite(canvas, sprite, &color, origin, bounds);
+}
@@ -0,0 +1,314 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_gfx_bench.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include "psq4_gfx.h"
+
+
+// As the Adafruit 1.14" display driven by psq4-ui
+#define BENCH_CANVAS_W 240
+#define BENCH_CANVAS_H 135
+// As psq4-ui flushes, one SPI transaction at a time
+#define BENCH_FLUSH_BUFFER_BYTES 4096
+// As the status bar icons
+#define BENCH_ICON_W 21
+#define BENCH_ICON_H 16
+#define BENCH_BACKGROUND 0x0000
+#define BENCH_FOREGROUND 0xE007
+
+#define BENCH_CLEAR_FRAMES 100
+#define BENCH_ICON_FRAMES 2000
+#define BENCH_SCATTER_FRAMES 200
+#define BENCH_SCATTER_PIXELS 256
+#define BENCH_FRAGMENT_FRAMES 500
+// Enough single pixels, spread over the canvas, to force merging of dirty regions
+#define BENCH_FRAGMENT_GRID 4
+#define BENCH_FILL_FRAMES 200
+
+
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    int64_t draw_us;
+    int64_t flush_us;
+    uint64_t pixels_drawn;
+    uint64_t bytes_flushed;
+    uint32_t chunks;
+} bench_result_t;
+
+
+static uint8_t flush_buffer[BENCH_FLUSH_BUFFER_BYTES];
+static uint16_t raw_icon_data[BENCH_ICON_W * BENCH_ICON_H];
+// A header and a color per run, and at most three runs per row
+static uint8_t rle_icon_data[BENCH_ICON_H * 3 * 3];
+static psq4_gfx_sprite_t raw_icon = { raw_icon_data, { BENCH_ICON_W, BENCH_ICON_H } };
+static psq4_gfx_rle_sprite_t rle_icon = { rle_icon_data, { BENCH_ICON_W, BENCH_ICON_H } };
+
+
+// A gradient rectangle, and a centered disc with transparent surroundings,
+// like the status icons
+static void make_icons()
+{
+    size_t len = 0;
+    int r = BENCH_ICON_H / 2;
+    for (int y = 0; y < BENCH_ICON_H; y++) {
+        for (int x = 0; x < BENCH_ICON_W; x++) {
+            raw_icon_data[y * BENCH_ICON_W + x] = (uint16_t) ((x << 11) | (y << 5) | (x ^ y));
+        }
+        int dy = 2 * y + 1 - 2 * r;
+        int inside = 0;
+        while (inside < r && (2 * inside + 1) * (2 * inside + 1) + dy * dy <= 4 * r * r) inside++;
+        int left = (BENCH_ICON_W - 2 * inside) / 2;
+        int right = BENCH_ICON_W - 2 * inside - left;
+        if (left > 0) rle_icon_data[len++] = PSQ4_GFX_RLE_SKIP | (left - 1);
+        if (inside > 0) {
+            rle_icon_data[len++] = PSQ4_GFX_RLE_FILL | (2 * inside - 1);
+            rle_icon_data[len++] = BENCH_FOREGROUND >> 8;
+            rle_icon_data[len++] = BENCH_FOREGROUND & 0xFF;
+        }
+        if (right > 0) rle_icon_data[len++] = PSQ4_GFX_RLE_SKIP | (right - 1);
+    }
+}
+
+
+// Flushes every dirty region, timing it as a frame
+static void flush_frame(psq4_gfx_canvas_t *canvas, bench_result_t *result)
+{
+    psq4_gfx_bounds_t bounds;
+    size_t len_bytes;
+    int64_t start = esp_timer_get_time();
+    while (canvas->dirty_rect_count > 0) {
+        len_bytes = 0;
+        psq4_gfx_flush(canvas, flush_buffer, sizeof(flush_buffer), &bounds, &len_bytes);
+        result->bytes_flushed += len_bytes;
+        result->chunks++;
+    }
+    result->flush_us += esp_timer_get_time() - start;
+}
+
+
+static void report(const bench_result_t *result)
+{
+    double pixels_flushed = result->bytes_flushed / 2.0;
+    printf(
+        "%-16s %8.2f %8.2f %10" PRIu64 " %7.2f %9.2f\n",
+        result->name,
+        result->draw_us * 1000.0 / result->pixels_drawn,
+        pixels_flushed > 0 ? result->flush_us * 1000.0 / pixels_flushed : 0.0,
+        result->bytes_flushed / result->frames,
+        (double) result->chunks / result->frames,
+        pixels_flushed / result->pixels_drawn
+    );
+    // Let the idle task run, so as not to trip the task watchdog
+    vTaskDelay(1);
+}
+
+
+static void bench_full_clear(psq4_gfx_canvas_t *canvas)
+{
+    bench_result_t result = { .name = "full clear", .frames = BENCH_CLEAR_FRAMES };
+    psq4_gfx_bounds_t all = { 0, 0, BENCH_CANVAS_W - 1, BENCH_CANVAS_H - 1 };
+    for (uint32_t frame = 0; frame < result.frames; frame++) {
+        int64_t start = esp_timer_get_time();
+        psq4_gfx_fill_rect(canvas, frame & 1 ? BENCH_FOREGROUND : BENCH_BACKGROUND, &all);
+        result.draw_us += esp_timer_get_time() - start;
+        result.pixels_drawn += BENCH_CANVAS_W * BENCH_CANVAS_H;
+        flush_frame(canvas, &result);
+    }
+    report(&result);
+}
+
+
+// Replaces a status bar icon: erase the old one, draw the new one
+static void bench_status_icon(psq4_gfx_canvas_t *canvas)
+{
+    bench_result_t result = { .name = "status icon", .frames = BENCH_ICON_FRAMES };
+    psq4_gfx_coords_t origin = { BENCH_CANVAS_W - BENCH_ICON_W - 2, 2 };
+    psq4_gfx_bounds_t bounds;
+    for (uint32_t frame = 0; frame < result.frames; frame++) {
+        int64_t start = esp_timer_get_time();
+        psq4_gfx_erase_rle_sprite(canvas, &rle_icon, BENCH_BACKGROUND, &origin, &bounds);
+        psq4_gfx_render_rle_sprite(canvas, &rle_icon, &origin, &bounds);
+        result.draw_us += esp_timer_get_time() - start;
+        result.pixels_drawn += 2 * BENCH_ICON_W * BENCH_ICON_H;
+        flush_frame(canvas, &result);
+    }
+    report(&result);
+}
+
+
+static void bench_raw_sprite(psq4_gfx_canvas_t *canvas)
+{
+    bench_result_t result = { .name = "raw sprite", .frames = BENCH_ICON_FRAMES };
+    psq4_gfx_coords_t origin = { 2, 2 };
+    psq4_gfx_bounds_t bounds;
+    for (uint32_t frame = 0; frame < result.frames; frame++) {
+        int64_t start = esp_timer_get_time();
+        psq4_gfx_render_sprite(canvas, &raw_icon, &origin, &bounds);
+        result.draw_us += esp_timer_get_time() - start;
+        result.pixels_drawn += BENCH_ICON_W * BENCH_ICON_H;
+        flush_frame(canvas, &result);
+    }
+    report(&result);
+}
+
+
+// Pixels at pseudo-random positions, a worst case for dirty region tracking
+static void bench_scattered_px(psq4_gfx_canvas_t *canvas)
+{
+    bench_result_t result = { .name = "scattered px", .frames = BENCH_SCATTER_FRAMES };
+    uint32_t seed = 1;
+    psq4_gfx_coords_t coords;
+    for (uint32_t frame = 0; frame < result.frames; frame++) {
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < BENCH_SCATTER_PIXELS; i++) {
+            seed = seed * 1664525 + 1013904223;
+            coords.x = (seed >> 8) % BENCH_CANVAS_W;
+            coords.y = (seed >> 20) % BENCH_CANVAS_H;
+            psq4_gfx_fill_px(canvas, (uint16_t) seed, &coords);
+        }
+        result.draw_us += esp_timer_get_time() - start;
+        result.pixels_drawn += BENCH_SCATTER_PIXELS;
+        flush_frame(canvas, &result);
+    }
+    report(&result);
+}
+
+
+// A grid of single pixels spanning the canvas, more regions than are
+// tracked, so that flushing is as fragmented and as wasteful as it gets
+static void bench_fragmented(psq4_gfx_canvas_t *canvas)
+{
+    bench_result_t result = { .name = "fragmented", .frames = BENCH_FRAGMENT_FRAMES };
+    psq4_gfx_coords_t coords;
+    for (uint32_t frame = 0; frame < result.frames; frame++) {
+        int64_t start = esp_timer_get_time();
+        for (int row = 0; row < BENCH_FRAGMENT_GRID; row++) {
+            for (int col = 0; col < BENCH_FRAGMENT_GRID; col++) {
+                coords.x = col * (BENCH_CANVAS_W - 1) / (BENCH_FRAGMENT_GRID - 1);
+                coords.y = row * (BENCH_CANVAS_H - 1) / (BENCH_FRAGMENT_GRID - 1);
+                psq4_gfx_fill_px(canvas, (uint16_t) frame, &coords);
+            }
+        }
+        result.draw_us += esp_timer_get_time() - start;
+        result.pixels_drawn += BENCH_FRAGMENT_GRID * BENCH_FRAGMENT_GRID;
+        flush_frame(canvas, &result);
+    }
+    report(&result);
+}
+
+
+// psq4_gfx_fill_rect() as it was before row-span kernels: one indexed
+// 16-bit store per pixel. Dirty regions are not tracked, which if
+// anything flatters it.
+static void legacy_fill_rect(
+    psq4_gfx_canvas_t *canvas,
+    uint16_t color,
+    const psq4_gfx_bounds_t *bounds)
+{
+    xSemaphoreTake(canvas->mutex, portMAX_DELAY);
+    size_t j;
+    for (uint8_t y = bounds->y0; y <= bounds->y1; y++) {
+        for (uint8_t x = bounds->x0; x <= bounds->x1; x++) {
+            j = (y * canvas->dim.w) + x;
+            canvas->data[j] = color;
+        }
+    }
+    xSemaphoreGive(canvas->mutex);
+}
+
+
+// Fill rate of psq4_gfx_fill_rect(), before and after row-span kernels
+static void bench_fill_kernel(
+    psq4_gfx_canvas_t *canvas,
+    const char *name,
+    psq4_gfx_bounds_t *bounds)
+{
+    uint32_t pixels = (uint32_t) (bounds->x1 - bounds->x0 + 1) * (bounds->y1 - bounds->y0 + 1);
+    int64_t start = esp_timer_get_time();
+    for (uint32_t frame = 0; frame < BENCH_FILL_FRAMES; frame++) {
+        legacy_fill_rect(canvas, (uint16_t) frame, bounds);
+    }
+    int64_t legacy_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (uint32_t frame = 0; frame < BENCH_FILL_FRAMES; frame++) {
+        psq4_gfx_fill_rect(canvas, (uint16_t) frame, bounds);
+    }
+    int64_t spans_us = esp_timer_get_time() - start;
+    bench_result_t ignored = { 0 };
+    flush_frame(canvas, &ignored);
+    printf(
+        "%-16s %10.2f %10.2f %8.2f\n",
+        name,
+        (double) pixels * BENCH_FILL_FRAMES / (legacy_us > 0 ? legacy_us : 1),
+        (double) pixels * BENCH_FILL_FRAMES / (spans_us > 0 ? spans_us : 1),
+        spans_us > 0 ? (double) legacy_us / spans_us : 0.0
+    );
+    vTaskDelay(1);
+}
+
+
+esp_err_t psq4_gfx_bench_run()
+{
+    psq4_gfx_canvas_t canvas;
+    psq4_gfx_dim_t dim = { BENCH_CANVAS_W, BENCH_CANVAS_H };
+    esp_err_t err = psq4_gfx_init(&canvas, &dim);
+    if (err != ESP_OK) return err;
+    make_icons();
+
+    // Flush the initial, fully dirty, canvas outside of any scenario
+    bench_result_t ignored = { 0 };
+    flush_frame(&canvas, &ignored);
+
+    printf(
+        "psq4-gfx benchmark, %dx%d canvas, %d-byte flush buffer\n",
+        BENCH_CANVAS_W,
+        BENCH_CANVAS_H,
+        BENCH_FLUSH_BUFFER_BYTES
+    );
+    printf("%-16s %8s %8s %10s %7s %9s\n", "scenario", "draw", "flush", "flushed", "chunks", "overdraw");
+    printf("%-16s %8s %8s %10s %7s %9s\n", "", "ns/px", "ns/px", "B/frame", "/frame", "px/px");
+    bench_full_clear(&canvas);
+    bench_status_icon(&canvas);
+    bench_raw_sprite(&canvas);
+    bench_scattered_px(&canvas);
+    bench_fragmented(&canvas);
+
+    psq4_gfx_bounds_t all = { 0, 0, BENCH_CANVAS_W - 1, BENCH_CANVAS_H - 1 };
+    // At an odd column, so that spans start unaligned
+    psq4_gfx_bounds_t icon = { 1, 1, BENCH_ICON_W, BENCH_ICON_H };
+    printf("\n%-16s %10s %10s %8s\n", "fill_rect", "per-px", "spans", "speedup");
+    printf("%-16s %10s %10s %8s\n", "", "Mpx/s", "Mpx/s", "x");
+    bench_fill_kernel(&canvas, "full clear", &all);
+    bench_fill_kernel(&canvas, "status icon", &icon);
+
+    psq4_gfx_free(&canvas);
+    return ESP_OK;
+}
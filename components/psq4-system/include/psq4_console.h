@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_CONSOLE_H
+#define PSQ4_CONSOLE_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Commands typed into the serial console (e.g. idf.py monitor), one
+// per line, as a name followed by space-separated arguments. "help"
+// lists the commands registered.
+
+
+/** @brief Most commands that can be registered */
+#define PSQ4_CONSOLE_MAX_COMMANDS 8
+
+/** @brief Most words in a command line, including the name */
+#define PSQ4_CONSOLE_MAX_ARGS 4
+
+
+/**
+ * @brief Carries out a command
+ *
+ * Runs on the console task, which has a 3 KB stack.
+ *
+ * @param argc The number of words, at least 1
+ * @param argv The words, argv[0] being the command's name
+ */
+typedef void (*psq4_console_handler_t)(int argc, char **argv);
+
+
+/**
+ * @brief Add a command
+ *
+ * Must be called before psq4_console_init().
+ *
+ * @param name The command's name, which must be a string literal
+ * @param usage Its arguments, for help, which must be a string literal
+ */
+void psq4_console_register(const char *name, const char *usage, psq4_console_handler_t handler);
+
+
+/** @brief Start reading commands */
+void psq4_console_init();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_CONSOLE_H
@@ -33,6 +33,12 @@
 // See https://www.esp32.com/viewtopic.php?t=1442#p6613
 #define PSQ4_SPI_MAX_TRANS_SIZE_BYTES 4096
 
+// Most DS18B20 sensors supported on the 1-Wire bus
+#define PSQ4_TEMPERATURE_MAX_SENSORS 8
+
+// Smoothed samples retained for subscribers, must be a power of two
+#define PSQ4_TEMPERATURE_BUS_SIZE 32
+
 #define PSQ4_WIFI_INITIALIZING_BIT            BIT0
 #define PSQ4_WIFI_CONNECTED_BIT               BIT1
 #define PSQ4_CLOCK_INITIALIZING_BIT           BIT2
@@ -44,6 +50,7 @@
 #define PSQ4_THERMOMETER_INITIALIZING_BIT     BIT10
 #define PSQ4_THERMOMETER_OK_BIT               BIT11
 #define PSQ4_MQTT_PUBLISH_FAILURE_BIT         BIT12
+#define PSQ4_MQTT_CIRCUIT_OPEN_BIT            BIT13
 
 
 #endif // PSQ4_CONSTANTS_H
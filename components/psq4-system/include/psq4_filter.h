@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_FILTER_H
+#define PSQ4_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Small filters for sample streams, in single-precision float, which
+// the ESP32's FPU does in hardware, or in Q16.16 fixed point, for
+// contexts where the FPU is off limits (such as ISRs). Constants and
+// coefficients are float, never double, which would be emulated in
+// software. Filters hold their own state and never allocate.
+
+
+/**
+ * @brief Exponentially weighted moving average
+ *
+ * Also a first-order low-pass filter; see
+ * psq4_filter_lowpass_init().
+ */
+typedef struct {
+    /** @brief Weight of each new sample, 0 to 1 */
+    float weight;
+    float value;
+    bool primed;
+} psq4_filter_ewma_t;
+
+
+/** @brief Start an EWMA; the first sample passes through unchanged */
+void psq4_filter_ewma_init(psq4_filter_ewma_t *filter, float weight);
+
+
+/**
+ * @brief Start a first-order low-pass filter
+ *
+ * @param time_constant The filter's RC time constant, in
+ *        the same units as period; the cutoff frequency is
+ *        1 / (2 * pi * time_constant)
+ * @param period The time between samples
+ */
+void psq4_filter_lowpass_init(psq4_filter_ewma_t *filter, float time_constant, float period);
+
+
+/** @brief Filter a sample, returning the new average */
+float psq4_filter_ewma_update(psq4_filter_ewma_t *filter, float sample);
+
+
+/** @brief Largest median window */
+#define PSQ4_FILTER_MEDIAN_MAX 9
+
+
+/** @brief Median of the last few samples, which rejects impulse noise */
+typedef struct {
+    float window[PSQ4_FILTER_MEDIAN_MAX];
+    uint8_t size;
+    uint8_t count;
+    uint8_t next;
+} psq4_filter_median_t;
+
+
+/**
+ * @brief Start a median filter
+ *
+ * @param size The window, odd and at most PSQ4_FILTER_MEDIAN_MAX
+ */
+void psq4_filter_median_init(psq4_filter_median_t *filter, uint8_t size);
+
+
+/**
+ * @brief Filter a sample, returning the median of the window
+ *
+ * Until the window fills, the median of the samples so far
+ * (the lower middle one, when there are an even number).
+ */
+float psq4_filter_median_update(psq4_filter_median_t *filter, float sample);
+
+
+/**
+ * @brief Rejects isolated jumps, which DS18B20s produce on a bad read
+ *
+ * A sample further than the threshold from the last one accepted is
+ * replaced by the last one accepted, unless max_rejects samples in a
+ * row have been, which suggests a genuine step change.
+ */
+typedef struct {
+    float threshold;
+    float value;
+    uint8_t max_rejects;
+    uint8_t rejects;
+    bool primed;
+} psq4_filter_spike_t;
+
+
+/** @brief Start a spike filter; the first sample is always accepted */
+void psq4_filter_spike_init(psq4_filter_spike_t *filter, float threshold, uint8_t max_rejects);
+
+
+/** @brief Filter a sample, returning the last sample accepted */
+float psq4_filter_spike_update(psq4_filter_spike_t *filter, float sample);
+
+
+/**
+ * @brief One-dimensional Kalman filter for a slowly drifting value
+ *
+ * Models the value as a random walk. The ratio of the noise
+ * variances sets the trade-off: a larger process_noise follows
+ * steps sooner, a larger measurement_noise smooths harder. The
+ * gain settles near sqrt(process_noise / measurement_noise)
+ * when that is small.
+ */
+typedef struct {
+    float process_noise;
+    float measurement_noise;
+    float value;
+    /** @brief Variance of the estimate */
+    float variance;
+    bool primed;
+} psq4_filter_kalman_t;
+
+
+/** @brief Start a Kalman filter; the first sample passes through unchanged */
+void psq4_filter_kalman_init(psq4_filter_kalman_t *filter, float process_noise, float measurement_noise);
+
+
+/** @brief Filter a sample, returning the new estimate */
+float psq4_filter_kalman_update(psq4_filter_kalman_t *filter, float sample);
+
+
+/** @brief Most stages in a filter chain */
+#define PSQ4_FILTER_CHAIN_MAX 4
+
+/** @brief Longest chain spec, including the terminator */
+#define PSQ4_FILTER_SPEC_MAX 128
+
+
+typedef enum {
+    PSQ4_FILTER_STAGE_SPIKE,
+    PSQ4_FILTER_STAGE_MEDIAN,
+    PSQ4_FILTER_STAGE_EWMA,
+    PSQ4_FILTER_STAGE_KALMAN
+} psq4_filter_stage_kind_t;
+
+
+/** @brief A stage's filter and parameters, in the order of its init function */
+typedef struct {
+    psq4_filter_stage_kind_t kind;
+    float params[2];
+} psq4_filter_stage_config_t;
+
+
+/** @brief The stages of a filter chain, applied in order */
+typedef struct {
+    psq4_filter_stage_config_t stages[PSQ4_FILTER_CHAIN_MAX];
+    uint8_t length;
+} psq4_filter_chain_config_t;
+
+
+/**
+ * @brief Filters applied one after another
+ *
+ * State for every stage is held inline, so a chain can be
+ * declared statically or on a stack and reconfigured without
+ * allocating.
+ */
+typedef struct {
+    struct {
+        psq4_filter_stage_kind_t kind;
+        union {
+            psq4_filter_spike_t spike;
+            psq4_filter_median_t median;
+            psq4_filter_ewma_t ewma;
+            psq4_filter_kalman_t kalman;
+        };
+    } stages[PSQ4_FILTER_CHAIN_MAX];
+    uint8_t length;
+} psq4_filter_chain_t;
+
+
+/** @brief Start a chain from a valid configuration, forgetting any state */
+void psq4_filter_chain_init(psq4_filter_chain_t *chain, const psq4_filter_chain_config_t *config);
+
+
+/** @brief Filter a sample through each stage; an empty chain passes it through */
+float psq4_filter_chain_update(psq4_filter_chain_t *chain, float sample);
+
+
+/**
+ * @brief Parse a chain from its text form
+ *
+ * Stages are separated by commas, each a name with optional
+ * colon-separated parameters, which default as shown:
+ *
+ *     spike:<threshold=1>:<max rejects=3>
+ *     median:<size=5>
+ *     ewma:<weight=0.2>
+ *     kalman:<process noise=0.0001>:<measurement noise=0.01>
+ *
+ * so "spike,median,kalman:0.001" is a complete spec. "none" is
+ * the empty chain.
+ *
+ * @return false, leaving config undefined, if the spec is
+ *         malformed, has too many stages or has out-of-range
+ *         parameters
+ */
+bool psq4_filter_chain_parse(const char *spec, psq4_filter_chain_config_t *config);
+
+
+/**
+ * @brief Write a chain's text form, with every parameter given
+ *
+ * @return The length of the text, which is truncated to fit
+ *         size like snprintf()
+ */
+size_t psq4_filter_chain_format(const psq4_filter_chain_config_t *config, char *text, size_t size);
+
+
+/** @brief A Q16.16 fixed-point number */
+typedef int32_t psq4_q16_t;
+
+#define PSQ4_Q16_ONE ((psq4_q16_t) 1 << 16)
+
+
+/** @brief Convert to Q16.16, rounding to nearest */
+static inline psq4_q16_t psq4_q16_from_float(float value)
+{
+    return (psq4_q16_t) (value * 65536.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+
+static inline float psq4_q16_to_float(psq4_q16_t value)
+{
+    return value * (1.0f / 65536.0f);
+}
+
+
+/** @brief Exponentially weighted moving average in Q16.16 */
+typedef struct {
+    psq4_q16_t weight;
+    psq4_q16_t value;
+    bool primed;
+} psq4_filter_ewma_q16_t;
+
+
+/** @brief Start an EWMA; the first sample passes through unchanged */
+void psq4_filter_ewma_q16_init(psq4_filter_ewma_q16_t *filter, psq4_q16_t weight);
+
+
+/** @brief Filter a sample, returning the new average */
+psq4_q16_t psq4_filter_ewma_q16_update(psq4_filter_ewma_q16_t *filter, psq4_q16_t sample);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_FILTER_H
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_RETRY_H
+#define PSQ4_RETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/** @brief Circuit breaker states */
+typedef enum {
+    /** @brief Retrying with exponential backoff */
+    PSQ4_RETRY_CLOSED = 0,
+    /** @brief Too many consecutive failures, resting */
+    PSQ4_RETRY_OPEN,
+    /** @brief Rested, one trial attempt allowed */
+    PSQ4_RETRY_HALF_OPEN,
+} psq4_retry_state_t;
+
+
+/** @brief How an operation is retried */
+typedef struct {
+    /** @brief Backoff ceiling after the first failure */
+    uint32_t base_ms;
+    /** @brief Greatest backoff ceiling */
+    uint32_t cap_ms;
+    /** @brief Consecutive failures that open the circuit, 0 for never */
+    uint32_t failure_threshold;
+    /** @brief How long an open circuit rests before a trial attempt */
+    uint32_t open_ms;
+    /**
+     * @brief Called with true as the circuit opens and false as it
+     *        closes again, or NULL
+     */
+    void (*on_open)(bool open);
+    /** @brief Source of jitter, or NULL for esp_random() */
+    uint32_t (*random)(void);
+    /** @brief Waits out a delay in milliseconds, or NULL for vTaskDelay() */
+    void (*sleep)(uint32_t ms);
+} psq4_retry_policy_t;
+
+
+/** @brief Retry state for one operation */
+typedef struct {
+    const psq4_retry_policy_t *policy;
+    /** @brief Consecutive failures */
+    uint32_t failures;
+    psq4_retry_state_t state;
+} psq4_retry_t;
+
+
+/** @brief Start retrying under a policy */
+void psq4_retry_init(psq4_retry_t *retry, const psq4_retry_policy_t *policy);
+
+
+/**
+ * @brief Record a failed attempt
+ *
+ * Below the failure threshold the delay is drawn
+ * uniformly from zero to the backoff ceiling, which
+ * doubles with each failure up to cap_ms ("full jitter").
+ * Reaching the threshold, or failing a trial attempt,
+ * opens the circuit for open_ms instead.
+ *
+ * @return Milliseconds to wait before the next attempt
+ */
+uint32_t psq4_retry_failed(psq4_retry_t *retry);
+
+
+/** @brief Record a successful attempt, closing the circuit */
+void psq4_retry_succeeded(psq4_retry_t *retry);
+
+
+/** @brief Record a failed attempt and wait out the delay */
+void psq4_retry_backoff(psq4_retry_t *retry);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_RETRY_H
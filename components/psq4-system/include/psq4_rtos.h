@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_RTOS_H
+#define PSQ4_RTOS_H
+
+#include <sdkconfig.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+
+
+// Creation of tasks and synchronization objects, allocated either from
+// the heap or, with CONFIG_PSQ4_STATIC_ALLOCATION, from memory reserved
+// at link time. Static storage is reserved per call site, so each call
+// site must only ever create one object. Arguments sizing storage must be
+// constant expressions.
+
+#if CONFIG_PSQ4_STATIC_ALLOCATION
+
+#define PSQ4_TASK_CREATE_PINNED(fn, name, stack_depth, params, priority, created_task, core) \
+    ({ \
+        static StackType_t psq4__stack[stack_depth]; \
+        static StaticTask_t psq4__task; \
+        TaskHandle_t *psq4__created_task = (created_task); \
+        TaskHandle_t psq4__handle = xTaskCreateStaticPinnedToCore( \
+            fn, name, stack_depth, params, priority, psq4__stack, &psq4__task, core \
+        ); \
+        if (psq4__created_task != NULL) *psq4__created_task = psq4__handle; \
+        psq4__handle != NULL ? pdPASS : errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY; \
+    })
+
+#define PSQ4_MUTEX_CREATE() \
+    ({ \
+        static StaticSemaphore_t psq4__semaphore; \
+        xSemaphoreCreateMutexStatic(&psq4__semaphore); \
+    })
+
+#define PSQ4_BINARY_SEMAPHORE_CREATE() \
+    ({ \
+        static StaticSemaphore_t psq4__semaphore; \
+        xSemaphoreCreateBinaryStatic(&psq4__semaphore); \
+    })
+
+#define PSQ4_QUEUE_CREATE(length, item_size) \
+    ({ \
+        static uint8_t psq4__storage[(length) * (item_size)]; \
+        static StaticQueue_t psq4__queue; \
+        xQueueCreateStatic(length, item_size, psq4__storage, &psq4__queue); \
+    })
+
+#define PSQ4_EVENT_GROUP_CREATE() \
+    ({ \
+        static StaticEventGroup_t psq4__event_group; \
+        xEventGroupCreateStatic(&psq4__event_group); \
+    })
+
+#else
+
+#define PSQ4_TASK_CREATE_PINNED(fn, name, stack_depth, params, priority, created_task, core) \
+    xTaskCreatePinnedToCore(fn, name, stack_depth, params, priority, created_task, core)
+
+#define PSQ4_MUTEX_CREATE() xSemaphoreCreateMutex()
+
+#define PSQ4_BINARY_SEMAPHORE_CREATE() xSemaphoreCreateBinary()
+
+#define PSQ4_QUEUE_CREATE(length, item_size) xQueueCreate(length, item_size)
+
+#define PSQ4_EVENT_GROUP_CREATE() xEventGroupCreate()
+
+#endif
+
+#define PSQ4_TASK_CREATE(fn, name, stack_depth, params, priority, created_task) \
+    PSQ4_TASK_CREATE_PINNED(fn, name, stack_depth, params, priority, created_task, tskNO_AFFINITY)
+
+
+#endif // PSQ4_RTOS_H
@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_SAMPLING_H
+#define PSQ4_SAMPLING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "psq4_constants.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+typedef enum {
+    /** @brief Full resolution, sampling often, while temperatures change */
+    PSQ4_SAMPLING_TRACKING,
+    /** @brief Reduced resolution, sampling seldom, while they hold steady */
+    PSQ4_SAMPLING_STEADY
+} psq4_sampling_mode_t;
+
+
+/**
+ * @brief Decides how hard to work at sensing
+ *
+ * Every sensor's reading is compared to the one it settled at. Once
+ * none has strayed more than a threshold for a hold time, sampling
+ * turns steady, and as soon as any strays further it turns back to
+ * tracking. Steady readings are coarser, so the threshold is never
+ * less than one step of their resolution, lest a temperature sitting
+ * between two steps flicker back to tracking.
+ *
+ * This is pure logic, so it builds for the host too.
+ */
+typedef struct {
+    float threshold;
+    /** @brief Degrees C per step of steady readings */
+    float steady_step;
+    /** @brief Time readings must hold steady, in psq4_sampling_decide()'s units */
+    uint32_t hold;
+    psq4_sampling_mode_t mode;
+    /** @brief When the last change was seen */
+    uint32_t settled_since;
+    bool changed;
+    /** @brief Sensors with an anchor, one bit per sensor id */
+    uint32_t anchored_mask;
+    /** @brief Readings each sensor settled at */
+    float anchors[PSQ4_TEMPERATURE_MAX_SENSORS];
+} psq4_sampling_t;
+
+
+/**
+ * @brief Start tracking
+ *
+ * @param threshold The change, in degrees C, that ends steady sampling
+ * @param steady_step The resolution of steady readings, in degrees C
+ * @param hold How long readings must stay within the threshold
+ *        before sampling turns steady
+ */
+void psq4_sampling_init(psq4_sampling_t *sampling, float threshold, float steady_step, uint32_t hold);
+
+
+/** @brief Take account of a successful reading */
+void psq4_sampling_observe(psq4_sampling_t *sampling, size_t sensor_id, float value);
+
+
+/**
+ * @brief Decide how to sample next, once every sensor has been read
+ *
+ * @param time Now; must not decrease from one call to the next
+ */
+psq4_sampling_mode_t psq4_sampling_decide(psq4_sampling_t *sampling, uint32_t time);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_SAMPLING_H
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_SMOOTHING_H
+#define PSQ4_SMOOTHING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "psq4_filter.h"
+#include "psq4_swinging_door.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Smooths one sensor's readings and decides which to distribute
+ *
+ * Readings are smoothed by a filter chain, then compressed by swinging
+ * door trending, so that straight lines between the temperatures
+ * distributed stay within a deviation of every smoothed reading. Slow
+ * ramps cost few points, and curves as many as they need. This is pure
+ * logic, so it builds for the host too.
+ */
+typedef struct {
+    psq4_filter_chain_t chain;
+    psq4_swinging_door_t door;
+} psq4_smoothing_t;
+
+
+/** @brief The chain used unless another is configured: ewma:0.2 */
+extern const psq4_filter_chain_config_t psq4_smoothing_default_filter;
+
+
+/**
+ * @brief Forget all readings
+ *
+ * @param filter The chain to smooth with
+ * @param deviation The most, in degrees C, that a line between
+ *        temperatures distributed may stray from the smoothed readings
+ * @param max_interval The longest time between temperatures
+ *        distributed, in the units of psq4_smoothing_update()'s
+ *        time, or 0 for no limit
+ */
+void psq4_smoothing_init(
+    psq4_smoothing_t *smoothing,
+    const psq4_filter_chain_config_t *filter,
+    float deviation,
+    uint32_t max_interval
+);
+
+
+/**
+ * @brief Smooth with another chain from the next reading
+ *
+ * The new chain starts afresh, but compression carries on
+ * from the last temperature distributed.
+ */
+void psq4_smoothing_configure(psq4_smoothing_t *smoothing, const psq4_filter_chain_config_t *filter);
+
+
+/**
+ * @brief Smooth a reading
+ *
+ * A temperature to distribute is decided only once later
+ * readings show that it is needed, so it is usually that of
+ * an earlier reading, and is never that of a later one.
+ *
+ * @param time When the reading was taken, replaced by the
+ *        time of the temperature to distribute, if any; must
+ *        increase from one reading to the next
+ * @param value The reading, replaced likewise
+ * @return true if a temperature should be distributed
+ */
+bool psq4_smoothing_update(psq4_smoothing_t *smoothing, uint32_t *time, float *value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_SMOOTHING_H
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_SWINGING_DOOR_H
+#define PSQ4_SWINGING_DOOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Swinging-door trending compressor
+ *
+ * Archives as few points of a series as it can while a straight line
+ * between consecutive archived points stays within the deviation of
+ * every point offered. From the last archived point, two "doors" pivot
+ * to admit each new point plus or minus the deviation; once they
+ * swing past parallel, no single line fits, and a point at the time of
+ * the previous one is archived, on the line that fits best.
+ *
+ * An archived point's value can differ from the offered point's, by up
+ * to the deviation. Times are in any unit, but must increase, and may
+ * wrap.
+ */
+typedef struct {
+    float deviation;
+    /** @brief Longest time between archived points, 0 for no limit */
+    uint32_t max_interval;
+    uint32_t origin_time;
+    float origin_value;
+    uint32_t last_time;
+    float last_value;
+    /** @brief Least and greatest slope from the origin that fits every point since */
+    float lower_slope;
+    float upper_slope;
+    bool primed;
+    /** @brief Whether a point has been offered since the origin */
+    bool pending;
+} psq4_swinging_door_t;
+
+
+/** @brief Start a compressor; the first point offered is archived */
+void psq4_swinging_door_init(psq4_swinging_door_t *door, float deviation, uint32_t max_interval);
+
+
+/**
+ * @brief Offer a point
+ *
+ * @param time The point's time, replaced by that of the
+ *        point to archive, if any
+ * @param value The point's value, likewise
+ * @return true if a point should be archived
+ */
+bool psq4_swinging_door_update(psq4_swinging_door_t *door, uint32_t *time, float *value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_SWINGING_DOOR_H
@@ -31,6 +31,7 @@
 #include <freertos/event_groups.h>
 #include <driver/spi_master.h>
 #include <esp_err.h>
+#include "psq4_constants.h"
 
 
 typedef struct {
@@ -42,6 +43,85 @@ typedef struct {
 typedef psq4_system_t* psq4_system_handle_t;
 
 
+/** @brief Outcome of a temperature acquisition */
+typedef enum {
+    PSQ4_TEMPERATURE_SAMPLE_OK = 0,
+    PSQ4_TEMPERATURE_SAMPLE_READ_FAILED,
+} psq4_temperature_sample_status_t;
+
+
+/** @brief A single timestamped temperature reading */
+typedef struct {
+    /** @brief Temperature in degrees C, valid only if status is OK */
+    float value;
+    /** @brief Tick count at which the reading was acquired */
+    TickType_t tick;
+    /**
+     * @brief Epoch seconds at which the reading was acquired,
+     *        meaningful only once the clock is reliable
+     */
+    time_t timestamp;
+    /** @brief Identifies the sensor that produced the reading */
+    uint8_t sensor_id;
+    /** @brief Whether the reading succeeded */
+    psq4_temperature_sample_status_t status;
+} psq4_temperature_sample_t;
+
+
+/**
+ * @brief Buckets in the sampling histograms
+ *
+ * Bucket i counts durations under 100 us * 10^i, less those
+ * counted in bucket i - 1; the last counts all longer ones.
+ * So: 100 us, 1 ms, 10 ms, 100 ms, 1 s, and beyond.
+ */
+#define PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS 6
+
+
+/** @brief Temperature pipeline counters, for diagnostics */
+typedef struct {
+    /** @brief Samples handed from sensing to distribution */
+    uint32_t samples;
+    /** @brief Samples dropped because distribution fell behind */
+    uint32_t overflows;
+    /** @brief Most samples ever waiting for distribution at once */
+    uint32_t high_water;
+    /** @brief Smoothed samples published to subscribers */
+    uint32_t published;
+    /**
+     * @brief Sweeps of the bus, by how far the time since the
+     *        previous sweep strayed from the sampling period
+     */
+    uint32_t jitter[PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS];
+    /** @brief Sweeps that outlasted the sampling period, by how much */
+    uint32_t overruns[PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS];
+} psq4_temperature_stats_t;
+
+
+/**
+ * @brief A subscription to smoothed temperature samples
+ *
+ * Subscribers own their subscription state, so there is
+ * no limit on their number and publishing costs the same
+ * however many there are. Initialize with
+ * psq4_temperature_subscribe() and then only read it.
+ */
+typedef struct {
+    /** @brief Sensors of interest, one bit per sensor id */
+    uint32_t sensor_mask;
+    /** @brief Minimum ticks between samples from any one sensor */
+    TickType_t min_interval;
+    /** @brief Sequence number of the next sample to consider */
+    uint32_t cursor;
+    /** @brief Sensors that have delivered at least one sample */
+    uint32_t delivered_mask;
+    /** @brief Tick of the last sample delivered per sensor */
+    TickType_t last_ticks[PSQ4_TEMPERATURE_MAX_SENSORS];
+    /** @brief Samples overwritten before this subscriber read them */
+    uint32_t missed;
+} psq4_temperature_subscriber_t;
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -68,12 +148,65 @@ time_t psq4_system_time();
 
 
 /**
- * @brief Register as a consumer of temperature changes
+ * @brief Subscribe to smoothed temperature changes
+ *
+ * Only samples published after this call are delivered.
+ * Samples are compressed by swinging door trending (see
+ * psq4_smoothing.h): lines between them stay within
+ * CONFIG_PSQ4_TELEMETRY_DEVIATION of the smoothed
+ * temperature, and each is published some readings after
+ * its tick.
+ *
+ * @param subscriber The subscription state to initialize
+ * @param sensor_mask One bit per sensor id of interest,
+ *        e.g. BIT0 for the first sensor on the bus
+ * @param min_interval Samples from a sensor arriving less
+ *        than this many ticks after the last one delivered
+ *        from that sensor are skipped; 0 delivers them all
+ */
+void psq4_temperature_subscribe(
+    psq4_temperature_subscriber_t *subscriber,
+    uint32_t sensor_mask,
+    TickType_t min_interval
+);
+
+
+/**
+ * @brief Wait for the next sample for a subscriber
+ *
+ * The sample is not copied: it points into a slot shared
+ * by all subscribers that stays valid until
+ * PSQ4_TEMPERATURE_BUS_SIZE more samples are published,
+ * so use it promptly.
+ *
+ * @return ESP_OK if a sample was delivered, otherwise
+ *         ESP_ERR_TIMEOUT
+ */
+esp_err_t psq4_temperature_next(
+    psq4_temperature_subscriber_t *subscriber,
+    const psq4_temperature_sample_t **sample,
+    TickType_t xTicksToWait
+);
+
+
+/** @brief Obtain a snapshot of the temperature pipeline counters */
+void psq4_temperature_get_stats(psq4_temperature_stats_t *stats);
+
+
+/**
+ * @brief Change how a sensor's readings are smoothed
+ *
+ * The new filter chain starts with the sensor's next reading,
+ * and is kept in NVS across restarts. The serial console offers
+ * the same as "filter <sensor id> <spec>".
  *
- * Temperature changes will be emitted via direct to task "mailbox"
- * notifications, using xTaskNotify(). Consume with xTaskNotifyWait().
+ * @param spec A chain, as documented for psq4_filter_chain_parse(),
+ *        or "default"
+ * @return ESP_ERR_INVALID_ARG for an unknown sensor or a bad spec,
+ *         ESP_ERR_TIMEOUT if earlier changes have yet to be taken
+ *         up, or an NVS error if the chain applies but was not saved
  */
-esp_err_t psq4_temperature_add_consumer(TaskHandle_t task, TickType_t xTicksToWait);
+esp_err_t psq4_temperature_set_filter(uint8_t sensor_id, const char *spec);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_TRACE_H
+#define PSQ4_TRACE_H
+
+#include <stdint.h>
+#include <sdkconfig.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Latency tracing. Events are stamped with the CPU cycle counter and
+// written to a ring per core without taking locks, so they are cheap
+// enough for hot paths. Typing "trace" into the serial console prints
+// the rings, and tools/psq4_trace_chrome.py converts the output for
+// chrome://tracing or Perfetto.
+//
+// Without CONFIG_PSQ4_TRACE the macros expand to nothing and their
+// arguments are not evaluated. Names must be string literals, and only
+// tasks that are never deleted may record events.
+
+#if CONFIG_PSQ4_TRACE
+
+/** @brief Begin a span of time on the current task */
+#define PSQ4_TRACE_BEGIN(name) psq4_trace_record('B', name, 0)
+/** @brief End the current task's innermost span */
+#define PSQ4_TRACE_END(name) psq4_trace_record('E', name, 0)
+/** @brief Mark a moment on the current task, with a value */
+#define PSQ4_TRACE_INSTANT(name, arg) psq4_trace_record('i', name, arg)
+/** @brief Begin a span that may end on another task, identified by id */
+#define PSQ4_TRACE_ASYNC_BEGIN(name, id) psq4_trace_record('b', name, id)
+/** @brief End the span of the given name and id */
+#define PSQ4_TRACE_ASYNC_END(name, id) psq4_trace_record('e', name, id)
+
+#else
+
+#define PSQ4_TRACE_BEGIN(name) do {} while (0)
+#define PSQ4_TRACE_END(name) do {} while (0)
+#define PSQ4_TRACE_INSTANT(name, arg) do {} while (0)
+#define PSQ4_TRACE_ASYNC_BEGIN(name, id) do {} while (0)
+#define PSQ4_TRACE_ASYNC_END(name, id) do {} while (0)
+
+#endif
+
+
+/**
+ * @brief Record an event; use the PSQ4_TRACE_* macros instead
+ *
+ * @param phase The Chrome trace event phase: B, E, i, b or e
+ */
+void psq4_trace_record(char phase, const char *name, uint32_t arg);
+
+
+/** @brief Add the trace command to the serial console */
+void psq4_trace_init();
+
+
+/**
+ * @brief Print the trace rings to stdout
+ *
+ * Recording is suspended while the rings are printed, so events
+ * occurring meanwhile are lost.
+ */
+void psq4_trace_dump();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_TRACE_H
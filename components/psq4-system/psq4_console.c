@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_console.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_system.h>
+#include <driver/uart.h>
+#include <esp_vfs_dev.h>
+#include "psq4_rtos.h"
+
+
+#define CONSOLE_LINE_LENGTH 160
+
+
+typedef struct {
+    const char *name;
+    const char *usage;
+    psq4_console_handler_t handler;
+} console_command_t;
+
+
+static const char * PSQ4_CONSOLE_TAG = "psq4-console";
+static console_command_t commands[PSQ4_CONSOLE_MAX_COMMANDS];
+static size_t command_count = 0;
+
+
+void psq4_console_register(const char *name, const char *usage, psq4_console_handler_t handler)
+{
+    if (command_count == PSQ4_CONSOLE_MAX_COMMANDS) {
+        ESP_LOGE(PSQ4_CONSOLE_TAG, "FATAL: No room for console command '%s'", name);
+        esp_restart();
+    }
+    commands[command_count].name = name;
+    commands[command_count].usage = usage;
+    commands[command_count].handler = handler;
+    command_count++;
+}
+
+
+static void print_help()
+{
+    for (size_t i = 0; i < command_count; i++) {
+        printf("%s %s\n", commands[i].name, commands[i].usage);
+    }
+}
+
+
+static void run_line(char *line)
+{
+    char *argv[PSQ4_CONSOLE_MAX_ARGS];
+    int argc = 0;
+    char *saveptr;
+    for (char *word = strtok_r(line, " \t", &saveptr); word != NULL; word = strtok_r(NULL, " \t", &saveptr)) {
+        if (argc == PSQ4_CONSOLE_MAX_ARGS) {
+            ESP_LOGW(PSQ4_CONSOLE_TAG, "Too many arguments to '%s'", argv[0]);
+            return;
+        }
+        argv[argc++] = word;
+    }
+    if (argc == 0) return;
+    if (strcmp(argv[0], "help") == 0) {
+        print_help();
+        return;
+    }
+    for (size_t i = 0; i < command_count; i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            commands[i].handler(argc, argv);
+            return;
+        }
+    }
+    ESP_LOGW(PSQ4_CONSOLE_TAG, "Unknown command '%s'; try 'help'", argv[0]);
+}
+
+
+// Reads commands, one per line, from the serial console
+static void console_task(void *ignored)
+{
+    // Blocking reads of stdin require the UART driver
+    setvbuf(stdin, NULL, _IONBF, 0);
+    esp_vfs_dev_uart_set_rx_line_endings(ESP_LINE_ENDINGS_CR);
+    ESP_ERROR_CHECK(uart_driver_install(CONFIG_ESP_CONSOLE_UART_NUM, 256, 0, 0, NULL, 0));
+    esp_vfs_dev_uart_use_driver(CONFIG_ESP_CONSOLE_UART_NUM);
+
+    char line[CONSOLE_LINE_LENGTH];
+    while (true) {
+        if (fgets(line, sizeof(line), stdin) == NULL) {
+            vTaskDelay(100 / portTICK_PERIOD_MS);
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        run_line(line);
+    }
+}
+
+
+void psq4_console_init()
+{
+    PSQ4_TASK_CREATE(
+        &console_task,
+        "consoleTask",
+        3072,
+        NULL,
+        1,
+        NULL
+    );
+}
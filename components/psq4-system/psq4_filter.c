@@ -0,0 +1,308 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_filter.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+void psq4_filter_ewma_init(psq4_filter_ewma_t *filter, float weight)
+{
+    filter->weight = weight;
+    filter->value = 0.0f;
+    filter->primed = false;
+}
+
+
+void psq4_filter_lowpass_init(psq4_filter_ewma_t *filter, float time_constant, float period)
+{
+    psq4_filter_ewma_init(filter, period / (time_constant + period));
+}
+
+
+float psq4_filter_ewma_update(psq4_filter_ewma_t *filter, float sample)
+{
+    if (!filter->primed) {
+        filter->value = sample;
+        filter->primed = true;
+    }
+    // Equivalent to (1 - w) * value + w * sample, less a multiply
+    filter->value += filter->weight * (sample - filter->value);
+    return filter->value;
+}
+
+
+void psq4_filter_median_init(psq4_filter_median_t *filter, uint8_t size)
+{
+    assert(size > 0 && size <= PSQ4_FILTER_MEDIAN_MAX && (size & 1));
+    filter->size = size;
+    filter->count = 0;
+    filter->next = 0;
+}
+
+
+float psq4_filter_median_update(psq4_filter_median_t *filter, float sample)
+{
+    filter->window[filter->next] = sample;
+    filter->next = filter->next + 1 == filter->size ? 0 : filter->next + 1;
+    if (filter->count < filter->size) filter->count++;
+
+    // Insertion sort of a copy; windows are tiny
+    float sorted[PSQ4_FILTER_MEDIAN_MAX];
+    for (uint8_t i = 0; i < filter->count; i++) {
+        float value = filter->window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    return sorted[(filter->count - 1) / 2];
+}
+
+
+void psq4_filter_spike_init(psq4_filter_spike_t *filter, float threshold, uint8_t max_rejects)
+{
+    filter->threshold = threshold;
+    filter->value = 0.0f;
+    filter->max_rejects = max_rejects;
+    filter->rejects = 0;
+    filter->primed = false;
+}
+
+
+float psq4_filter_spike_update(psq4_filter_spike_t *filter, float sample)
+{
+    if (
+        filter->primed &&
+        fabsf(sample - filter->value) > filter->threshold &&
+        filter->rejects < filter->max_rejects
+       )
+    {
+        filter->rejects++;
+        return filter->value;
+    }
+    filter->value = sample;
+    filter->rejects = 0;
+    filter->primed = true;
+    return sample;
+}
+
+
+void psq4_filter_kalman_init(psq4_filter_kalman_t *filter, float process_noise, float measurement_noise)
+{
+    filter->process_noise = process_noise;
+    filter->measurement_noise = measurement_noise;
+    filter->value = 0.0f;
+    filter->variance = 0.0f;
+    filter->primed = false;
+}
+
+
+float psq4_filter_kalman_update(psq4_filter_kalman_t *filter, float sample)
+{
+    if (!filter->primed) {
+        // The first sample is as good an estimate as there is
+        filter->value = sample;
+        filter->variance = filter->measurement_noise;
+        filter->primed = true;
+        return sample;
+    }
+    float predicted = filter->variance + filter->process_noise;
+    float gain = predicted / (predicted + filter->measurement_noise);
+    filter->value += gain * (sample - filter->value);
+    filter->variance = (1.0f - gain) * predicted;
+    return filter->value;
+}
+
+
+void psq4_filter_chain_init(psq4_filter_chain_t *chain, const psq4_filter_chain_config_t *config)
+{
+    assert(config->length <= PSQ4_FILTER_CHAIN_MAX);
+    for (uint8_t i = 0; i < config->length; i++) {
+        const psq4_filter_stage_config_t *stage = &config->stages[i];
+        chain->stages[i].kind = stage->kind;
+        switch (stage->kind) {
+            case PSQ4_FILTER_STAGE_SPIKE:
+                psq4_filter_spike_init(&chain->stages[i].spike, stage->params[0], (uint8_t) stage->params[1]);
+                break;
+            case PSQ4_FILTER_STAGE_MEDIAN:
+                psq4_filter_median_init(&chain->stages[i].median, (uint8_t) stage->params[0]);
+                break;
+            case PSQ4_FILTER_STAGE_EWMA:
+                psq4_filter_ewma_init(&chain->stages[i].ewma, stage->params[0]);
+                break;
+            case PSQ4_FILTER_STAGE_KALMAN:
+                psq4_filter_kalman_init(&chain->stages[i].kalman, stage->params[0], stage->params[1]);
+                break;
+        }
+    }
+    chain->length = config->length;
+}
+
+
+float psq4_filter_chain_update(psq4_filter_chain_t *chain, float sample)
+{
+    for (uint8_t i = 0; i < chain->length; i++) {
+        switch (chain->stages[i].kind) {
+            case PSQ4_FILTER_STAGE_SPIKE:
+                sample = psq4_filter_spike_update(&chain->stages[i].spike, sample);
+                break;
+            case PSQ4_FILTER_STAGE_MEDIAN:
+                sample = psq4_filter_median_update(&chain->stages[i].median, sample);
+                break;
+            case PSQ4_FILTER_STAGE_EWMA:
+                sample = psq4_filter_ewma_update(&chain->stages[i].ewma, sample);
+                break;
+            case PSQ4_FILTER_STAGE_KALMAN:
+                sample = psq4_filter_kalman_update(&chain->stages[i].kalman, sample);
+                break;
+        }
+    }
+    return sample;
+}
+
+
+typedef struct {
+    const char *name;
+    uint8_t param_count;
+    float defaults[2];
+} stage_syntax_t;
+
+// Indexed by psq4_filter_stage_kind_t
+static const stage_syntax_t stage_syntax[] = {
+    { "spike", 2, { 1.0f, 3.0f } },
+    { "median", 1, { 5.0f } },
+    { "ewma", 1, { 0.2f } },
+    { "kalman", 2, { 0.0001f, 0.01f } }
+};
+
+
+static bool stage_valid(const psq4_filter_stage_config_t *stage)
+{
+    float a = stage->params[0];
+    float b = stage->params[1];
+    switch (stage->kind) {
+        case PSQ4_FILTER_STAGE_SPIKE:
+            return a > 0.0f && b >= 1.0f && b <= 255.0f && b == (uint8_t) b;
+        case PSQ4_FILTER_STAGE_MEDIAN:
+            return a >= 1.0f && a <= PSQ4_FILTER_MEDIAN_MAX && a == (uint8_t) a && ((uint8_t) a & 1);
+        case PSQ4_FILTER_STAGE_EWMA:
+            return a > 0.0f && a <= 1.0f;
+        case PSQ4_FILTER_STAGE_KALMAN:
+            return a >= 0.0f && b > 0.0f;
+    }
+    return false;
+}
+
+
+bool psq4_filter_chain_parse(const char *spec, psq4_filter_chain_config_t *config)
+{
+    config->length = 0;
+    if (strcmp(spec, "none") == 0) return true;
+    const char *cursor = spec;
+    while (true) {
+        if (config->length == PSQ4_FILTER_CHAIN_MAX) return false;
+        psq4_filter_stage_config_t *stage = &config->stages[config->length];
+        size_t name_length = strcspn(cursor, ":,");
+        size_t kind;
+        for (kind = 0; kind < sizeof(stage_syntax) / sizeof(stage_syntax[0]); kind++) {
+            const char *name = stage_syntax[kind].name;
+            if (strlen(name) == name_length && strncmp(cursor, name, name_length) == 0) break;
+        }
+        if (kind == sizeof(stage_syntax) / sizeof(stage_syntax[0])) return false;
+        stage->kind = (psq4_filter_stage_kind_t) kind;
+        stage->params[0] = stage_syntax[kind].defaults[0];
+        stage->params[1] = stage_syntax[kind].defaults[1];
+        cursor += name_length;
+        for (uint8_t i = 0; *cursor == ':'; i++) {
+            if (i == stage_syntax[kind].param_count) return false;
+            char *end;
+            stage->params[i] = strtof(cursor + 1, &end);
+            if (end == cursor + 1 || !isfinite(stage->params[i])) return false;
+            cursor = end;
+        }
+        if (!stage_valid(stage)) return false;
+        config->length++;
+        if (*cursor == '\0') return true;
+        if (*cursor != ',') return false;
+        cursor++;
+    }
+}
+
+
+// snprintf() at an offset, counting what would have been written
+static size_t append(char *text, size_t size, size_t length, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text + (length < size ? length : size), length < size ? size - length : 0, format, args);
+    va_end(args);
+    return length + (written > 0 ? written : 0);
+}
+
+
+size_t psq4_filter_chain_format(const psq4_filter_chain_config_t *config, char *text, size_t size)
+{
+    if (config->length == 0) {
+        return append(text, size, 0, "none");
+    }
+    size_t length = 0;
+    for (uint8_t i = 0; i < config->length; i++) {
+        const psq4_filter_stage_config_t *stage = &config->stages[i];
+        const stage_syntax_t *syntax = &stage_syntax[stage->kind];
+        length = append(text, size, length, "%s%s", i > 0 ? "," : "", syntax->name);
+        for (uint8_t j = 0; j < syntax->param_count; j++) {
+            length = append(text, size, length, ":%g", (double) stage->params[j]);
+        }
+    }
+    return length;
+}
+
+
+void psq4_filter_ewma_q16_init(psq4_filter_ewma_q16_t *filter, psq4_q16_t weight)
+{
+    filter->weight = weight;
+    filter->value = 0;
+    filter->primed = false;
+}
+
+
+psq4_q16_t psq4_filter_ewma_q16_update(psq4_filter_ewma_q16_t *filter, psq4_q16_t sample)
+{
+    if (!filter->primed) {
+        filter->value = sample;
+        filter->primed = true;
+    }
+    int64_t step = (int64_t) filter->weight * (sample - filter->value);
+    // Rounded to nearest; a shift, as 64-bit division is done in software
+    filter->value += (psq4_q16_t) ((step + PSQ4_Q16_ONE / 2) >> 16);
+    return filter->value;
+}
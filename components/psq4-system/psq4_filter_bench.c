@@ -0,0 +1,229 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_filter_bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include "psq4_filter.h"
+#include "psq4_smoothing.h"
+#include "psq4_swinging_door.h"
+
+#if defined(ESP_PLATFORM)
+#include <xtensa/hal.h>
+#define BENCH_HAVE_CYCLES 1
+#define bench_cycles() xthal_get_ccount()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_CYCLES 1
+#define bench_cycles() ((uint32_t) __rdtsc())
+#else
+#define BENCH_HAVE_CYCLES 0
+#define bench_cycles() 0
+#endif
+
+
+#define BENCH_SAMPLES 1024
+#define BENCH_PASSES 64
+
+
+typedef struct {
+    const char *name;
+    int64_t us;
+    uint64_t cycles;
+    /** @brief Samples a smoothing would distribute */
+    uint32_t distributed;
+} bench_result_t;
+
+
+static float samples[BENCH_SAMPLES];
+static psq4_q16_t q16_samples[BENCH_SAMPLES];
+// Keeps filter results from being optimized away
+static volatile float sink;
+
+
+// A slow ramp with DS18B20-like noise, at 12-bit resolution (1/16 C)
+static void make_samples()
+{
+    uint32_t seed = 1;
+    for (size_t i = 0; i < BENCH_SAMPLES; i++) {
+        seed = seed * 1664525 + 1013904223;
+        float noise = (int32_t) ((seed >> 24) % 5) - 2;
+        samples[i] = roundf((20.0f + i * 0.001f) * 16 + noise) / 16;
+        q16_samples[i] = psq4_q16_from_float(samples[i]);
+    }
+}
+
+
+// The smoothing distributed before psq4_filter.h, whose double
+// literals made every operation double precision
+#define LEGACY_INVALID -1024.0
+#define LEGACY_WEIGHT 0.2
+#define LEGACY_CHANGE_THRESHOLD 0.0125
+
+static float legacy_ewma = LEGACY_INVALID;
+static float legacy_distributed = LEGACY_INVALID;
+
+static bool legacy_smoothing_update(float *value)
+{
+    float ewma_temperature = legacy_ewma;
+    if (ewma_temperature == LEGACY_INVALID) {
+        ewma_temperature = *value;
+    }
+    ewma_temperature =
+            ((1 - LEGACY_WEIGHT) * ewma_temperature) +
+            (LEGACY_WEIGHT * *value);
+    legacy_ewma = ewma_temperature;
+    *value = ewma_temperature;
+    if (fabs(ewma_temperature - legacy_distributed) > LEGACY_CHANGE_THRESHOLD) {
+        legacy_distributed = ewma_temperature;
+        return true;
+    }
+    return false;
+}
+
+
+#define BENCH(result, body) \
+    do { \
+        int64_t bench__start = esp_timer_get_time(); \
+        for (int pass = 0; pass < BENCH_PASSES; pass++) { \
+            uint32_t bench__cycles = bench_cycles(); \
+            for (size_t i = 0; i < BENCH_SAMPLES; i++) { \
+                body; \
+            } \
+            (result)->cycles += (uint32_t) (bench_cycles() - bench__cycles); \
+        } \
+        (result)->us = esp_timer_get_time() - bench__start; \
+    } while (0)
+
+
+static void report(const bench_result_t *result)
+{
+    double count = (double) BENCH_SAMPLES * BENCH_PASSES;
+    if (BENCH_HAVE_CYCLES) {
+        printf("%-20s %8.2f %8.1f\n", result->name, result->us * 1000.0 / count, result->cycles / count);
+    } else {
+        printf("%-20s %8.2f %8s\n", result->name, result->us * 1000.0 / count, "-");
+    }
+    // Let the idle task run, so as not to trip the task watchdog
+    vTaskDelay(1);
+}
+
+
+void psq4_filter_bench_run()
+{
+    make_samples();
+    printf("psq4-filter benchmark, %d samples x %d passes\n", BENCH_SAMPLES, BENCH_PASSES);
+    printf("%-20s %8s %8s\n", "filter", "ns", "cycles");
+
+    bench_result_t legacy = { .name = "legacy smoothing" };
+    float value;
+    BENCH(&legacy, {
+        value = samples[i];
+        if (legacy_smoothing_update(&value)) {
+            sink = value;
+            legacy.distributed++;
+        }
+    });
+    report(&legacy);
+
+    bench_result_t smoothing_result = { .name = "smoothing" };
+    psq4_smoothing_t smoothing;
+    psq4_smoothing_init(&smoothing, &psq4_smoothing_default_filter, 0.05f, 0);
+    uint32_t time;
+    BENCH(&smoothing_result, {
+        value = samples[i];
+        time = pass * BENCH_SAMPLES + i;
+        if (psq4_smoothing_update(&smoothing, &time, &value)) {
+            sink = value;
+            smoothing_result.distributed++;
+        }
+    });
+    report(&smoothing_result);
+
+    bench_result_t ewma_result = { .name = "ewma" };
+    psq4_filter_ewma_t ewma;
+    psq4_filter_ewma_init(&ewma, 0.2f);
+    BENCH(&ewma_result, sink = psq4_filter_ewma_update(&ewma, samples[i]));
+    report(&ewma_result);
+
+    bench_result_t ewma_q16_result = { .name = "ewma q16.16" };
+    psq4_filter_ewma_q16_t ewma_q16;
+    psq4_filter_ewma_q16_init(&ewma_q16, psq4_q16_from_float(0.2f));
+    BENCH(&ewma_q16_result, sink = psq4_filter_ewma_q16_update(&ewma_q16, q16_samples[i]));
+    report(&ewma_q16_result);
+
+    bench_result_t median5_result = { .name = "median of 5" };
+    psq4_filter_median_t median;
+    psq4_filter_median_init(&median, 5);
+    BENCH(&median5_result, sink = psq4_filter_median_update(&median, samples[i]));
+    report(&median5_result);
+
+    bench_result_t median9_result = { .name = "median of 9" };
+    psq4_filter_median_init(&median, 9);
+    BENCH(&median9_result, sink = psq4_filter_median_update(&median, samples[i]));
+    report(&median9_result);
+
+    bench_result_t spike_result = { .name = "spike" };
+    psq4_filter_spike_t spike;
+    psq4_filter_spike_init(&spike, 1.0f, 3);
+    BENCH(&spike_result, sink = psq4_filter_spike_update(&spike, samples[i]));
+    report(&spike_result);
+
+    bench_result_t kalman_result = { .name = "kalman" };
+    psq4_filter_kalman_t kalman;
+    psq4_filter_kalman_init(&kalman, 0.0001f, 0.01f);
+    BENCH(&kalman_result, sink = psq4_filter_kalman_update(&kalman, samples[i]));
+    report(&kalman_result);
+
+    // A chain of every stage, as a worst case for the distribution task
+    bench_result_t chain_result = { .name = "chain of all four" };
+    psq4_filter_chain_config_t config;
+    psq4_filter_chain_parse("spike,median,ewma,kalman", &config);
+    psq4_filter_chain_t chain;
+    psq4_filter_chain_init(&chain, &config);
+    BENCH(&chain_result, sink = psq4_filter_chain_update(&chain, samples[i]));
+    report(&chain_result);
+
+    bench_result_t door_result = { .name = "swinging door" };
+    psq4_swinging_door_t door;
+    psq4_swinging_door_init(&door, 0.05f, 0);
+    BENCH(&door_result, {
+        value = samples[i];
+        time = pass * BENCH_SAMPLES + i;
+        if (psq4_swinging_door_update(&door, &time, &value)) sink = value;
+    });
+    report(&door_result);
+
+    printf(
+        "distributed of %d: legacy %" PRIu32 ", smoothing %" PRIu32 "\n",
+        BENCH_SAMPLES * BENCH_PASSES,
+        legacy.distributed,
+        smoothing_result.distributed
+    );
+}
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_retry.h"
+
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_system.h>
+#include <esp_log.h>
+
+
+static const char * PSQ4_RETRY_TAG = "psq4-system/retry";
+
+
+void psq4_retry_init(psq4_retry_t *retry, const psq4_retry_policy_t *policy)
+{
+    retry->policy = policy;
+    retry->failures = 0;
+    retry->state = PSQ4_RETRY_CLOSED;
+}
+
+
+// The circuit counts as open through trial attempts, until it closes
+static void psq4_retry_set_state(psq4_retry_t *retry, psq4_retry_state_t state)
+{
+    void (*on_open)(bool open) = retry->policy->on_open;
+    if (retry->state == PSQ4_RETRY_CLOSED && state == PSQ4_RETRY_OPEN) {
+        ESP_LOGW(
+            PSQ4_RETRY_TAG,
+            "Circuit opened after %d consecutive failures, trying every %d ms",
+            retry->failures,
+            retry->policy->open_ms
+        );
+        if (on_open) on_open(true);
+    } else if (retry->state != PSQ4_RETRY_CLOSED && state == PSQ4_RETRY_CLOSED) {
+        ESP_LOGI(PSQ4_RETRY_TAG, "Circuit closed");
+        if (on_open) on_open(false);
+    }
+    retry->state = state;
+}
+
+
+uint32_t psq4_retry_failed(psq4_retry_t *retry)
+{
+    const psq4_retry_policy_t *policy = retry->policy;
+    retry->failures++;
+    if (
+        retry->state == PSQ4_RETRY_HALF_OPEN ||
+        (policy->failure_threshold > 0 && retry->failures >= policy->failure_threshold)
+       )
+    {
+        psq4_retry_set_state(retry, PSQ4_RETRY_OPEN);
+        return policy->open_ms;
+    }
+    uint32_t ceiling = policy->base_ms;
+    for (uint32_t i = 1; i < retry->failures && ceiling < policy->cap_ms; i++) {
+        ceiling *= 2;
+    }
+    if (ceiling > policy->cap_ms) ceiling = policy->cap_ms;
+    uint32_t random = policy->random ? policy->random() : esp_random();
+    return random % (ceiling + 1);
+}
+
+
+void psq4_retry_succeeded(psq4_retry_t *retry)
+{
+    retry->failures = 0;
+    psq4_retry_set_state(retry, PSQ4_RETRY_CLOSED);
+}
+
+
+void psq4_retry_backoff(psq4_retry_t *retry)
+{
+    uint32_t delay_ms = psq4_retry_failed(retry);
+    if (retry->policy->sleep) {
+        retry->policy->sleep(delay_ms);
+    } else {
+        vTaskDelay(delay_ms / portTICK_PERIOD_MS);
+    }
+    // Whatever comes next is the trial attempt
+    if (retry->state == PSQ4_RETRY_OPEN) psq4_retry_set_state(retry, PSQ4_RETRY_HALF_OPEN);
+}
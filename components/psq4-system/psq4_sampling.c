@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_sampling.h"
+
+#include <math.h>
+
+
+void psq4_sampling_init(psq4_sampling_t *sampling, float threshold, float steady_step, uint32_t hold)
+{
+    sampling->threshold = threshold;
+    sampling->steady_step = steady_step;
+    sampling->hold = hold;
+    sampling->mode = PSQ4_SAMPLING_TRACKING;
+    // So that the hold starts with the first decision
+    sampling->changed = true;
+    sampling->anchored_mask = 0;
+}
+
+
+void psq4_sampling_observe(psq4_sampling_t *sampling, size_t sensor_id, float value)
+{
+    uint32_t sensor_bit = 1 << sensor_id;
+    if ((sampling->anchored_mask & sensor_bit) == 0) {
+        sampling->anchors[sensor_id] = value;
+        sampling->anchored_mask |= sensor_bit;
+        return;
+    }
+    float threshold = sampling->threshold;
+    if (sampling->mode == PSQ4_SAMPLING_STEADY && threshold < sampling->steady_step) {
+        threshold = sampling->steady_step;
+    }
+    if (fabsf(value - sampling->anchors[sensor_id]) > threshold) {
+        sampling->anchors[sensor_id] = value;
+        sampling->changed = true;
+    }
+}
+
+
+psq4_sampling_mode_t psq4_sampling_decide(psq4_sampling_t *sampling, uint32_t time)
+{
+    if (sampling->changed) {
+        sampling->changed = false;
+        sampling->settled_since = time;
+        if (sampling->mode == PSQ4_SAMPLING_STEADY) {
+            sampling->mode = PSQ4_SAMPLING_TRACKING;
+            // Anchors read at steady resolution are too coarse to keep
+            sampling->anchored_mask = 0;
+        }
+    } else if (sampling->mode == PSQ4_SAMPLING_TRACKING && time - sampling->settled_since >= sampling->hold) {
+        sampling->mode = PSQ4_SAMPLING_STEADY;
+        // Re-anchor at steady resolution, which may round differently
+        sampling->anchored_mask = 0;
+    }
+    return sampling->mode;
+}
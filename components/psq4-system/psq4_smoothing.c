@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_smoothing.h"
+
+
+#define PSQ4_TEMPERATURE_WEIGHT 0.2f
+
+
+const psq4_filter_chain_config_t psq4_smoothing_default_filter = {
+    .stages = { { PSQ4_FILTER_STAGE_EWMA, { PSQ4_TEMPERATURE_WEIGHT } } },
+    .length = 1
+};
+
+
+void psq4_smoothing_init(
+    psq4_smoothing_t *smoothing,
+    const psq4_filter_chain_config_t *filter,
+    float deviation,
+    uint32_t max_interval)
+{
+    psq4_smoothing_configure(smoothing, filter);
+    psq4_swinging_door_init(&smoothing->door, deviation, max_interval);
+}
+
+
+void psq4_smoothing_configure(psq4_smoothing_t *smoothing, const psq4_filter_chain_config_t *filter)
+{
+    psq4_filter_chain_init(&smoothing->chain, filter);
+}
+
+
+bool psq4_smoothing_update(psq4_smoothing_t *smoothing, uint32_t *time, float *value)
+{
+    *value = psq4_filter_chain_update(&smoothing->chain, *value);
+    return psq4_swinging_door_update(&smoothing->door, time, value);
+}
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_swinging_door.h"
+
+
+void psq4_swinging_door_init(psq4_swinging_door_t *door, float deviation, uint32_t max_interval)
+{
+    door->deviation = deviation;
+    door->max_interval = max_interval;
+    door->primed = false;
+    door->pending = false;
+}
+
+
+// Points the doors at a point, the first since the origin
+static void open_doors(psq4_swinging_door_t *door, uint32_t time, float value)
+{
+    float elapsed = (float) (time - door->origin_time);
+    door->lower_slope = (value - door->deviation - door->origin_value) / elapsed;
+    door->upper_slope = (value + door->deviation - door->origin_value) / elapsed;
+    door->last_time = time;
+    door->last_value = value;
+    door->pending = true;
+}
+
+
+bool psq4_swinging_door_update(psq4_swinging_door_t *door, uint32_t *time, float *value)
+{
+    if (!door->primed) {
+        door->origin_time = *time;
+        door->origin_value = *value;
+        door->primed = true;
+        return true;
+    }
+    uint32_t elapsed = *time - door->origin_time;
+    if (elapsed == 0) return false;
+    if (!door->pending) {
+        open_doors(door, *time, *value);
+        return false;
+    }
+
+    float lower = (*value - door->deviation - door->origin_value) / elapsed;
+    float upper = (*value + door->deviation - door->origin_value) / elapsed;
+    if (lower < door->lower_slope) lower = door->lower_slope;
+    if (upper > door->upper_slope) upper = door->upper_slope;
+    if (lower <= upper && (door->max_interval == 0 || elapsed <= door->max_interval)) {
+        door->lower_slope = lower;
+        door->upper_slope = upper;
+        door->last_time = *time;
+        door->last_value = *value;
+        return false;
+    }
+
+    // The doors have swung past parallel, so archive a point at the last
+    // time on the line that fits, as near the last value as that allows.
+    // The last value itself may be off the line by up to the deviation.
+    uint32_t last_elapsed = door->last_time - door->origin_time;
+    float slope = (door->last_value - door->origin_value) / last_elapsed;
+    if (slope < door->lower_slope) slope = door->lower_slope;
+    if (slope > door->upper_slope) slope = door->upper_slope;
+    door->origin_value += slope * last_elapsed;
+    door->origin_time = door->last_time;
+    open_doors(door, *time, *value);
+    *time = door->origin_time;
+    *value = door->origin_value;
+    return true;
+}
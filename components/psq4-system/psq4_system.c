@@ -29,6 +29,9 @@
 #include <esp_log.h>
 #include <nvs_flash.h>
 #include "psq4_constants.h"
+#include "psq4_rtos.h"
+#include "psq4_trace.h"
+#include "psq4_console.h"
 
 extern void psq4_time_init(EventGroupHandle_t system_event_group);
 extern time_t psq4_time_now();
@@ -67,7 +70,7 @@ static void spi_init()
 
 
 psq4_system_handle_t psq4_system_init() {
-    EventGroupHandle_t event_group = xEventGroupCreate();
+    EventGroupHandle_t event_group = PSQ4_EVENT_GROUP_CREATE();
     if (event_group == NULL) {
       ESP_LOGE(PSQ4_SYSTEM_TAG, "Failed to create event group");
       esp_restart();
@@ -93,6 +96,14 @@ psq4_system_handle_t psq4_system_init() {
     // Initialize timekeeping
     psq4_time_init(event_group);
 
+#if CONFIG_PSQ4_TRACE
+    // Accept the trace command on the serial console
+    psq4_trace_init();
+#endif
+
+    // Read commands once all have been registered
+    psq4_console_init();
+
     return &_psq4_system;
 }
 
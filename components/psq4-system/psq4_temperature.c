@@ -26,17 +26,27 @@
  * https://github.com/DavidAntliff/esp32-ds18b20-example
  */
 
-#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
 #include <freertos/semphr.h>
 #include <freertos/event_groups.h>
 #include <driver/rmt.h>
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <nvs.h>
 #include <owb.h>
 #include <owb_rmt.h>
 #include "psq4_constants.h"
+#include "psq4_system.h"
+#include "psq4_rtos.h"
+#include "psq4_trace.h"
+#include "psq4_smoothing.h"
+#include "psq4_console.h"
+#include "psq4_sampling.h"
 #include <ds18b20.h>
 
 
@@ -47,47 +57,145 @@ typedef struct {
     rmt_channel_t rx_channel;
     DS18B20_RESOLUTION resolution;
     EventGroupHandle_t event_group;
+    /** @brief ROM codes of the devices discovered on the bus */
+    OneWireBus_ROMCode rom_codes[PSQ4_TEMPERATURE_MAX_SENSORS];
+    /** @brief Devices, indexed by sensor id */
+    DS18B20_Info * devices[PSQ4_TEMPERATURE_MAX_SENSORS];
+    size_t device_count;
 } psq4_temperature_sensor_t;
 
 
-#define PSQ4_TEMPERATURE_MAX_CONSUMERS 2
-#define PSQ4_TEMPERATURE_INVALID -1024.0
-#define PSQ4_TEMPERATURE_WEIGHT 0.2
-#define PSQ4_TEMPERATURE_CHANGE_THRESHOLD 0.0125
+// Must be a power of two
+#define PSQ4_TEMPERATURE_RING_SIZE 32
+#define PSQ4_TEMPERATURE_RING_MASK (PSQ4_TEMPERATURE_RING_SIZE - 1)
+#define PSQ4_TEMPERATURE_BUS_MASK (PSQ4_TEMPERATURE_BUS_SIZE - 1)
+// Set when the number of samples ever published is even or odd, respectively
+#define PSQ4_TEMPERATURE_BUS_EVEN_BIT BIT0
+#define PSQ4_TEMPERATURE_BUS_ODD_BIT BIT1
+#define PSQ4_TEMPERATURE_BUS_PARITY_BIT(seq) \
+    (((seq) & 1) ? PSQ4_TEMPERATURE_BUS_ODD_BIT : PSQ4_TEMPERATURE_BUS_EVEN_BIT)
+// Longest a caught-up subscriber sleeps before looking at the bus again
+#define PSQ4_TEMPERATURE_BUS_RECHECK pdMS_TO_TICKS(CONFIG_PSQ4_SAMPLING_PERIOD_MS)
+
+#if CONFIG_PSQ4_SAMPLING_STEADY_RESOLUTION_9_BIT
+#define PSQ4_TEMPERATURE_STEADY_RESOLUTION DS18B20_RESOLUTION_9_BIT
+#define PSQ4_TEMPERATURE_STEADY_STEP 0.5f
+#else
+#define PSQ4_TEMPERATURE_STEADY_RESOLUTION DS18B20_RESOLUTION_10_BIT
+#define PSQ4_TEMPERATURE_STEADY_STEP 0.25f
+#endif
+
+#define PSQ4_TEMPERATURE_NVS_NAMESPACE "psq4-filter"
+#define PSQ4_TEMPERATURE_FILTER_KEY "sensor%u"
+#define PSQ4_TEMPERATURE_DEFAULT_FILTER "default"
+
+
+typedef struct {
+    uint8_t sensor_id;
+    psq4_filter_chain_config_t filter;
+} psq4_temperature_filter_change_t;
+
 
 static const char * PSQ4_TEMPERATURE_TAG = "psq4-system/thermometer";
 static psq4_temperature_sensor_t psq4_temperature_sensor;
 static TaskHandle_t psq4_temperature_distribute_task;
-static TaskHandle_t psq4_temperature_consumers[PSQ4_TEMPERATURE_MAX_CONSUMERS];
-static size_t psq4_temperature_consumer_count = 0;
-static SemaphoreHandle_t psq4_temperature_consumer_mutex;
 
+// Smoothed samples, published by the distribution task and read in place
+// by any number of subscribers, each tracking its own position by sequence
+// number. The event group wakes every waiting subscriber in a single call.
+static psq4_temperature_sample_t psq4_temperature_bus[PSQ4_TEMPERATURE_BUS_SIZE];
+static uint32_t psq4_temperature_bus_seq = 0;
+static EventGroupHandle_t psq4_temperature_bus_events;
 
-static void psq4_temperature_sense(void * pvParameters)
+// Single-producer/single-consumer ring of samples between the sensing
+// and distribution tasks. Only the sensing task writes the head and
+// only the distribution task writes the tail, so no lock is needed.
+static psq4_temperature_sample_t psq4_temperature_ring[PSQ4_TEMPERATURE_RING_SIZE];
+static uint32_t psq4_temperature_ring_head = 0;
+static uint32_t psq4_temperature_ring_tail = 0;
+static psq4_temperature_stats_t psq4_temperature_stats;
+
+// Each sensor's filter chain as last configured, guarded by the mutex.
+// Changes reach the distribution task, which alone touches the chains'
+// state, by queue.
+static psq4_filter_chain_config_t psq4_temperature_filters[PSQ4_TEMPERATURE_MAX_SENSORS];
+static SemaphoreHandle_t psq4_temperature_filters_mutex;
+static QueueHandle_t psq4_temperature_filter_changes;
+static psq4_smoothing_t psq4_temperature_smoothing[PSQ4_TEMPERATURE_MAX_SENSORS];
+
+
+// Called only from the sensing task
+static bool psq4_temperature_ring_push(const psq4_temperature_sample_t *sample)
 {
-    psq4_temperature_sensor_t * sensor = (psq4_temperature_sensor_t *) pvParameters;
+    uint32_t head = psq4_temperature_ring_head;
+    uint32_t tail = __atomic_load_n(&psq4_temperature_ring_tail, __ATOMIC_ACQUIRE);
+    uint32_t depth = head - tail;
+    if (depth == PSQ4_TEMPERATURE_RING_SIZE) {
+        psq4_temperature_stats.overflows++;
+        return false;
+    }
+    psq4_temperature_ring[head & PSQ4_TEMPERATURE_RING_MASK] = *sample;
+    __atomic_store_n(&psq4_temperature_ring_head, head + 1, __ATOMIC_RELEASE);
+    psq4_temperature_stats.samples++;
+    if (depth + 1 > psq4_temperature_stats.high_water) {
+        psq4_temperature_stats.high_water = depth + 1;
+    }
+    return true;
+}
 
-    // Stable readings require a brief period before communication
-    vTaskDelay(2000.0 / portTICK_PERIOD_MS);
 
-    // Create a 1-Wire bus, using the RMT timeslot driver
-    OneWireBus * owb;
-    owb_rmt_driver_info rmt_driver_info;
-    owb = owb_rmt_initialize(
-        &rmt_driver_info,
-        sensor->oneWireGPIO,
-        sensor->tx_channel,
-        sensor->rx_channel
-    );
-    owb_use_crc(owb, true);
+// Called only from the distribution task
+static bool psq4_temperature_ring_pop(psq4_temperature_sample_t *sample)
+{
+    uint32_t tail = psq4_temperature_ring_tail;
+    uint32_t head = __atomic_load_n(&psq4_temperature_ring_head, __ATOMIC_ACQUIRE);
+    if (head == tail) return false;
+    *sample = psq4_temperature_ring[tail & PSQ4_TEMPERATURE_RING_MASK];
+    __atomic_store_n(&psq4_temperature_ring_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+
+// Called only from the distribution task
+static void psq4_temperature_bus_publish(const psq4_temperature_sample_t *sample)
+{
+    uint32_t seq = psq4_temperature_bus_seq;
+    // Subscribers that see seq advance past a slot's sample must be able
+    // to tell it may have been overwritten; order this after that advance
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    psq4_temperature_bus[seq & PSQ4_TEMPERATURE_BUS_MASK] = *sample;
+    __atomic_store_n(&psq4_temperature_bus_seq, seq + 1, __ATOMIC_RELEASE);
+    psq4_temperature_stats.published++;
+    // Subscribers that have caught up wait on the parity bit of the
+    // next sequence number; clear it before announcing this one
+    xEventGroupClearBits(psq4_temperature_bus_events, PSQ4_TEMPERATURE_BUS_PARITY_BIT(seq + 2));
+    xEventGroupSetBits(psq4_temperature_bus_events, PSQ4_TEMPERATURE_BUS_PARITY_BIT(seq + 1));
+}
+
+
+// Called only from the sensing task
+static void psq4_temperature_histogram_add(uint32_t *histogram, int64_t us)
+{
+    size_t bucket = 0;
+    for (int64_t bound = 100; bucket < PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS - 1 && us >= bound; bound *= 10) {
+        bucket++;
+    }
+    histogram[bucket]++;
+}
 
-    // Find connected device
+
+// Records the ROM code of every device on the bus, up to the table size
+static void psq4_temperature_discover(
+    psq4_temperature_sensor_t * sensor,
+    OneWireBus * owb)
+{
     int num_devices = 0;
     OneWireBus_SearchState search_state = {0};
     bool found = false;
+    sensor->device_count = 0;
     owb_search_first(owb, &search_state, &found);
     while (found) {
-        char rom_code_s[17];
+        char rom_code_s[OWB_ROM_CODE_STRING_LENGTH];
         owb_string_from_rom_code(
             search_state.rom_code,
             rom_code_s,
@@ -95,12 +203,23 @@ static void psq4_temperature_sense(void * pvParameters)
         );
         ESP_LOGI(
             PSQ4_TEMPERATURE_TAG,
-            "Seeking %s device, found candidate #%d: %s",
+            "Seeking %s devices, found candidate #%d: %s",
             sensor->name,
             ++num_devices,
             rom_code_s
         );
-        ++num_devices;
+        if (sensor->device_count < PSQ4_TEMPERATURE_MAX_SENSORS) {
+            sensor->rom_codes[sensor->device_count] = search_state.rom_code;
+            sensor->device_count++;
+        } else {
+            ESP_LOGW(
+                PSQ4_TEMPERATURE_TAG,
+                "Ignoring %s device %s, at most %d are supported",
+                sensor->name,
+                rom_code_s,
+                PSQ4_TEMPERATURE_MAX_SENSORS
+            );
+        }
         owb_search_next(owb, &search_state, &found);
     }
     ESP_LOGI(
@@ -110,91 +229,183 @@ static void psq4_temperature_sense(void * pvParameters)
         sensor->name,
         num_devices == 1 ? "" : "s"
     );
+}
 
-    // For a single device only:
-    OneWireBus_ROMCode rom_code;
-    owb_status status = owb_read_rom(owb, &rom_code);
-    if (status == OWB_STATUS_OK) {
-        char rom_code_s[OWB_ROM_CODE_STRING_LENGTH];
-        owb_string_from_rom_code(rom_code, rom_code_s, sizeof(rom_code_s));
-        ESP_LOGI(
-            PSQ4_TEMPERATURE_TAG,
-            "Single %s device (%s) present",
-            sensor->name,
-            rom_code_s
-        );
-    } else {
+
+// Reads the last conversion of one device, retrying on failure
+static int psq4_temperature_read(
+    psq4_temperature_sensor_t * sensor,
+    size_t sensor_id,
+    float * reading)
+{
+    int status_code;
+    int read_attempt = 0;
+    do {
+        status_code = ds18b20_read_temp(sensor->devices[sensor_id], reading);
+        if (status_code != DS18B20_OK) {
+            ESP_LOGW(
+                PSQ4_TEMPERATURE_TAG,
+                "%s #%d read attempt %d failed with code %d",
+                sensor->name,
+                sensor_id,
+                ++read_attempt,
+                status_code
+            );
+        }
+    } while (status_code != DS18B20_OK && read_attempt <= 3);
+    return status_code;
+}
+
+
+#if CONFIG_PSQ4_SAMPLING_ADAPTIVE
+// Changes the resolution of every device, and so its conversion time
+static void psq4_temperature_set_resolution(
+    psq4_temperature_sensor_t * sensor,
+    DS18B20_RESOLUTION resolution)
+{
+    for (size_t i = 0; i < sensor->device_count; i++) {
+        if (!ds18b20_set_resolution(sensor->devices[i], resolution)) {
+            ESP_LOGW(
+                PSQ4_TEMPERATURE_TAG,
+                "%s #%d failed to change to %d-bit resolution",
+                sensor->name,
+                i,
+                resolution
+            );
+        }
+    }
+    sensor->resolution = resolution;
+}
+#endif
+
+
+static void psq4_temperature_sense(void * pvParameters)
+{
+    psq4_temperature_sensor_t * sensor = (psq4_temperature_sensor_t *) pvParameters;
+
+    // Stable readings require a brief period before communication
+    vTaskDelay(2000.0 / portTICK_PERIOD_MS);
+
+    // Create a 1-Wire bus, using the RMT timeslot driver
+    OneWireBus * owb;
+    owb_rmt_driver_info rmt_driver_info;
+    owb = owb_rmt_initialize(
+        &rmt_driver_info,
+        sensor->oneWireGPIO,
+        sensor->tx_channel,
+        sensor->rx_channel
+    );
+    owb_use_crc(owb, true);
+
+    // Find connected devices
+    psq4_temperature_discover(sensor, owb);
+    while (sensor->device_count == 0) {
         ESP_LOGE(
             PSQ4_TEMPERATURE_TAG,
-            "An error occurred reading ROM code for %s: %d",
-            sensor->name,
-            status
+            "No %s devices found, searching again shortly",
+            sensor->name
         );
+        vTaskDelay(5000.0 / portTICK_PERIOD_MS);
+        psq4_temperature_discover(sensor, owb);
     }
 
-    DS18B20_Info * device = ds18b20_malloc();
-    ESP_LOGI(
-        PSQ4_TEMPERATURE_TAG,
-        "Single device optimizations enabled for %s",
-        sensor->name
-    );
-    ds18b20_init_solo(device, owb);
-    ds18b20_use_crc(device, true);
-    ds18b20_set_resolution(device, sensor->resolution);
+    for (size_t i = 0; i < sensor->device_count; i++) {
+        DS18B20_Info * device = ds18b20_malloc();
+        if (sensor->device_count == 1) {
+            // A lone device can be addressed without its ROM code
+            ESP_LOGI(
+                PSQ4_TEMPERATURE_TAG,
+                "Single device optimizations enabled for %s",
+                sensor->name
+            );
+            ds18b20_init_solo(device, owb);
+        } else {
+            ds18b20_init(device, owb, sensor->rom_codes[i]);
+        }
+        ds18b20_use_crc(device, true);
+        ds18b20_set_resolution(device, sensor->resolution);
+        sensor->devices[i] = device;
+    }
 
-    int status_code;
-    int error_count = 0;
-    int read_attempt;
     bool first_reading = true;
-    uint32_t notification_value;
+    bool all_ok;
+    // Sweep state is kept off the stack, which is left to the 1-Wire
+    // driver and to logging, whose float formatting needs over 1 KB
+    static psq4_temperature_sample_t samples[PSQ4_TEMPERATURE_MAX_SENSORS];
+    uint32_t period_ms = CONFIG_PSQ4_SAMPLING_PERIOD_MS;
+    TickType_t last_wake = xTaskGetTickCount();
+    int64_t sweep_start;
+    int64_t last_sweep_start = 0;
+#if CONFIG_PSQ4_SAMPLING_ADAPTIVE
+    static psq4_sampling_t sampling;
+    psq4_sampling_init(
+        &sampling,
+        CONFIG_PSQ4_SAMPLING_THRESHOLD / 1000.0f,
+        PSQ4_TEMPERATURE_STEADY_STEP,
+        pdMS_TO_TICKS(CONFIG_PSQ4_SAMPLING_HOLD_SECONDS * 1000)
+    );
+#endif
     while (true) {
+        sweep_start = esp_timer_get_time();
+        if (last_sweep_start != 0) {
+            int64_t jitter = sweep_start - last_sweep_start - period_ms * 1000LL;
+            psq4_temperature_histogram_add(psq4_temperature_stats.jitter, jitter < 0 ? -jitter : jitter);
+        }
+        last_sweep_start = sweep_start;
+
+        // Start every device converting at once, so that a sweep of the
+        // whole bus costs a single conversion delay
+        PSQ4_TRACE_BEGIN("convert");
         ds18b20_convert_all(owb);
 
         // In this application all devices use the same resolution,
         // so use the first device to determine the delay
-        ds18b20_wait_for_conversion(device);
+        ds18b20_wait_for_conversion(sensor->devices[0]);
+        PSQ4_TRACE_END("convert");
 
         // Read the results immediately after conversion otherwise it may fail
         // (using printf before reading may take too long)
+        for (size_t i = 0; i < sensor->device_count; i++) {
+            PSQ4_TRACE_BEGIN("read");
+            int status_code = psq4_temperature_read(sensor, i, &samples[i].value);
+            PSQ4_TRACE_END("read");
+            samples[i].tick = xTaskGetTickCount();
+            samples[i].timestamp = psq4_system_time();
+            samples[i].sensor_id = i;
+            samples[i].status = status_code == DS18B20_OK
+                ? PSQ4_TEMPERATURE_SAMPLE_OK
+                : PSQ4_TEMPERATURE_SAMPLE_READ_FAILED;
+        }
 
-        float reading;
-        read_attempt = 0;
-        do {
-            status_code = ds18b20_read_temp(device, &reading);
-            if (status_code != DS18B20_OK) {
-                ++error_count;
+        all_ok = true;
+        for (size_t i = 0; i < sensor->device_count; i++) {
+            if (!psq4_temperature_ring_push(&samples[i])) {
                 ESP_LOGW(
                     PSQ4_TEMPERATURE_TAG,
-                    "%s read attempt %d failed with code %d",
+                    "%s #%d sample dropped, %d overflows so far",
                     sensor->name,
-                    ++read_attempt,
-                    status_code
+                    i,
+                    psq4_temperature_stats.overflows
                 );
-                continue;
             }
-        } while (status_code != DS18B20_OK && read_attempt <= 3);
-
-        if (status_code == DS18B20_OK ) {
-            ESP_LOGD(
-                PSQ4_TEMPERATURE_TAG,
-                "%s read attempt %d: %.3f C",
-                sensor->name,
-                read_attempt,
-                reading
-            );
-
-            memcpy((void *) &notification_value, (const void *) &reading, sizeof(float));
-            BaseType_t result = xTaskNotify(psq4_temperature_distribute_task, notification_value, eSetValueWithOverwrite);
-            if (result != pdPASS) {
-                ESP_LOGE(
+            if (samples[i].status == PSQ4_TEMPERATURE_SAMPLE_OK) {
+#if CONFIG_PSQ4_SAMPLING_ADAPTIVE
+                psq4_sampling_observe(&sampling, i, samples[i].value);
+#endif
+                ESP_LOGD(
                     PSQ4_TEMPERATURE_TAG,
-                    "FATAL: Failed to emit %s temperature reading, code %d",
+                    "%s #%d: %.3f C",
                     sensor->name,
-                    result
+                    i,
+                    samples[i].value
                 );
-                esp_restart();
+            } else {
+                all_ok = false;
             }
+        }
+        xTaskNotifyGive(psq4_temperature_distribute_task);
 
+        if (all_ok) {
             if (first_reading) {
                 xEventGroupClearBits(sensor->event_group, PSQ4_THERMOMETER_INITIALIZING_BIT);
                 first_reading = false;
@@ -204,74 +415,288 @@ static void psq4_temperature_sense(void * pvParameters)
         } else {
             xEventGroupClearBits(sensor->event_group, PSQ4_THERMOMETER_OK_BIT);
         }
+
+#if CONFIG_PSQ4_SAMPLING_ADAPTIVE
+        bool steady = psq4_sampling_decide(&sampling, xTaskGetTickCount()) == PSQ4_SAMPLING_STEADY;
+        DS18B20_RESOLUTION resolution = steady
+            ? PSQ4_TEMPERATURE_STEADY_RESOLUTION
+            : DS18B20_RESOLUTION_12_BIT;
+        if (resolution != sensor->resolution) {
+            ESP_LOGI(
+                PSQ4_TEMPERATURE_TAG,
+                "%s temperatures %s, sampling at %d bits",
+                sensor->name,
+                steady ? "holding steady" : "changing",
+                resolution
+            );
+            PSQ4_TRACE_INSTANT("resolution", resolution);
+            psq4_temperature_set_resolution(sensor, resolution);
+            period_ms = steady
+                ? CONFIG_PSQ4_SAMPLING_STEADY_PERIOD_MS
+                : CONFIG_PSQ4_SAMPLING_PERIOD_MS;
+        }
+#endif
+
+        // Sweeps start a period apart, however long each takes, unless
+        // one outlasts the period; the next then starts at once, rather
+        // than several crowding in to catch up
+        int64_t overrun = esp_timer_get_time() - sweep_start - period_ms * 1000LL;
+        if (overrun >= 0) {
+            psq4_temperature_histogram_add(psq4_temperature_stats.overruns, overrun);
+            last_wake = xTaskGetTickCount();
+        } else {
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(period_ms));
+        }
     }
 }
 
 
 static void psq4_temperature_distribute(void * pvParameters) {
-    float distributed_temperature = PSQ4_TEMPERATURE_INVALID;
-    float ewma_temperature = PSQ4_TEMPERATURE_INVALID;
-    float current_temperature;
-    uint32_t notification_value;
-    BaseType_t wait_result;
-    BaseType_t send_result;
-    while((wait_result = xTaskNotifyWait(0, 0, &notification_value, portMAX_DELAY)) == pdTRUE) {
-        memcpy((void *) &current_temperature, (const void *) &notification_value, sizeof(float));
-        // EWMA smoothing
-        if (ewma_temperature == PSQ4_TEMPERATURE_INVALID) {
-            ewma_temperature = current_temperature;
+    // Smoothing is independent per sensor
+    for (size_t i = 0; i < PSQ4_TEMPERATURE_MAX_SENSORS; i++) {
+        psq4_smoothing_init(
+            &psq4_temperature_smoothing[i],
+            &psq4_temperature_filters[i],
+            CONFIG_PSQ4_TELEMETRY_DEVIATION / 1000.0f,
+            pdMS_TO_TICKS(CONFIG_PSQ4_TELEMETRY_MAX_INTERVAL_SECONDS * 1000)
+        );
+    }
+    psq4_temperature_sample_t sample;
+    psq4_temperature_filter_change_t change;
+    while (true) {
+        // Each notification may stand for several samples, so drain the ring
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (xQueueReceive(psq4_temperature_filter_changes, &change, 0) == pdTRUE) {
+            psq4_smoothing_configure(&psq4_temperature_smoothing[change.sensor_id], &change.filter);
         }
-        ewma_temperature =
-                ((1 - PSQ4_TEMPERATURE_WEIGHT) * ewma_temperature) +
-                (PSQ4_TEMPERATURE_WEIGHT * current_temperature);
-        if (fabs(ewma_temperature - distributed_temperature) > PSQ4_TEMPERATURE_CHANGE_THRESHOLD) {
-            memcpy((void *) &notification_value, (const void *) &ewma_temperature, sizeof(float));
-            size_t count = psq4_temperature_consumer_count;
-            for (size_t i = 0; i < count; i++) {
-                send_result = xTaskNotify(psq4_temperature_consumers[i], notification_value, eSetValueWithOverwrite);
-                if (send_result != pdPASS) {
-                    ESP_LOGE(
-                        PSQ4_TEMPERATURE_TAG,
-                        "FATAL: Failed to distribute temperature reading, code %d",
-                        send_result
-                    );
-                    esp_restart();
-                }
+        PSQ4_TRACE_BEGIN("distribute");
+        while (psq4_temperature_ring_pop(&sample)) {
+            if (sample.status != PSQ4_TEMPERATURE_SAMPLE_OK) continue;
+            uint32_t time = sample.tick;
+            if (psq4_smoothing_update(&psq4_temperature_smoothing[sample.sensor_id], &time, &sample.value)) {
+                // The temperature distributed may be an earlier reading's
+                sample.timestamp -= (sample.tick - time + configTICK_RATE_HZ / 2) / configTICK_RATE_HZ;
+                sample.tick = time;
+                psq4_temperature_bus_publish(&sample);
             }
-            distributed_temperature = ewma_temperature;
         }
-    };
-    ESP_LOGE(
-        PSQ4_TEMPERATURE_TAG,
-        "FATAL: failed to receive temperature reading from sensor, code %d",
-        wait_result
-    );
+        PSQ4_TRACE_END("distribute");
+    }
+}
+
+
+void psq4_temperature_subscribe(
+    psq4_temperature_subscriber_t *subscriber,
+    uint32_t sensor_mask,
+    TickType_t min_interval)
+{
+    subscriber->sensor_mask = sensor_mask;
+    subscriber->min_interval = min_interval;
+    subscriber->cursor = __atomic_load_n(&psq4_temperature_bus_seq, __ATOMIC_ACQUIRE);
+    subscriber->delivered_mask = 0;
+    subscriber->missed = 0;
 }
 
 
-esp_err_t psq4_temperature_add_consumer(TaskHandle_t task, TickType_t ticks_to_wait) {
-    if (xSemaphoreTake(psq4_temperature_consumer_mutex, ticks_to_wait) != pdTRUE) {
-        return ESP_ERR_TIMEOUT;
+static bool psq4_temperature_wanted(
+    psq4_temperature_subscriber_t *subscriber,
+    const psq4_temperature_sample_t *sample)
+{
+    uint32_t sensor_bit = 1 << sample->sensor_id;
+    if ((subscriber->sensor_mask & sensor_bit) == 0) return false;
+    if (
+        subscriber->min_interval > 0 &&
+        (subscriber->delivered_mask & sensor_bit) &&
+        sample->tick - subscriber->last_ticks[sample->sensor_id] < subscriber->min_interval
+       )
+    {
+        return false;
     }
-    esp_err_t result = ESP_OK;
-    if (psq4_temperature_consumer_count == PSQ4_TEMPERATURE_MAX_CONSUMERS) {
-        result = ESP_FAIL;
+    return true;
+}
+
+
+esp_err_t psq4_temperature_next(
+    psq4_temperature_subscriber_t *subscriber,
+    const psq4_temperature_sample_t **sample,
+    TickType_t ticks_to_wait)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t elapsed;
+    while (true) {
+        uint32_t seq = __atomic_load_n(&psq4_temperature_bus_seq, __ATOMIC_ACQUIRE);
+        while (subscriber->cursor != seq) {
+            if (seq - subscriber->cursor > PSQ4_TEMPERATURE_BUS_SIZE) {
+                // Fell so far behind that the oldest unread samples are gone
+                subscriber->missed += seq - subscriber->cursor - PSQ4_TEMPERATURE_BUS_SIZE;
+                subscriber->cursor = seq - PSQ4_TEMPERATURE_BUS_SIZE;
+            }
+            const psq4_temperature_sample_t *slot =
+                &psq4_temperature_bus[subscriber->cursor & PSQ4_TEMPERATURE_BUS_MASK];
+            bool wanted = psq4_temperature_wanted(subscriber, slot);
+            uint8_t sensor_id = slot->sensor_id;
+            TickType_t tick = slot->tick;
+            // The slot may have been overwritten while it was being read
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            seq = __atomic_load_n(&psq4_temperature_bus_seq, __ATOMIC_RELAXED);
+            if (seq - subscriber->cursor >= PSQ4_TEMPERATURE_BUS_SIZE) {
+                subscriber->missed++;
+                subscriber->cursor++;
+                continue;
+            }
+            subscriber->cursor++;
+            if (wanted) {
+                subscriber->delivered_mask |= 1 << sensor_id;
+                subscriber->last_ticks[sensor_id] = tick;
+                *sample = slot;
+                return ESP_OK;
+            }
+        }
+        elapsed = xTaskGetTickCount() - start;
+        if (ticks_to_wait != portMAX_DELAY && elapsed >= ticks_to_wait) {
+            return ESP_ERR_TIMEOUT;
+        }
+        // The bit stays set until the publish after next, so is only missed
+        // if two samples are published before this call; waking regularly
+        // to re-check the sequence bounds the delay that can cause
+        TickType_t remaining =
+            ticks_to_wait == portMAX_DELAY ? portMAX_DELAY : ticks_to_wait - elapsed;
+        xEventGroupWaitBits(
+            psq4_temperature_bus_events,
+            PSQ4_TEMPERATURE_BUS_PARITY_BIT(seq + 1),
+            false,
+            true,
+            remaining < PSQ4_TEMPERATURE_BUS_RECHECK ? remaining : PSQ4_TEMPERATURE_BUS_RECHECK
+        );
+    }
+}
+
+
+void psq4_temperature_get_stats(psq4_temperature_stats_t *stats)
+{
+    stats->samples = psq4_temperature_stats.samples;
+    stats->overflows = psq4_temperature_stats.overflows;
+    stats->high_water = psq4_temperature_stats.high_water;
+    stats->published = psq4_temperature_stats.published;
+    memcpy(stats->jitter, psq4_temperature_stats.jitter, sizeof(stats->jitter));
+    memcpy(stats->overruns, psq4_temperature_stats.overruns, sizeof(stats->overruns));
+}
+
+
+static esp_err_t psq4_temperature_save_filter(uint8_t sensor_id, const char *spec)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    snprintf(key, sizeof(key), PSQ4_TEMPERATURE_FILTER_KEY, sensor_id);
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(PSQ4_TEMPERATURE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) return err;
+    if (spec == NULL) {
+        err = nvs_erase_key(nvs, key);
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
     } else {
-        psq4_temperature_consumers[psq4_temperature_consumer_count] = task;
-        psq4_temperature_consumer_count++;
+        err = nvs_set_str(nvs, key, spec);
     }
-    if (xSemaphoreGive(psq4_temperature_consumer_mutex) != pdTRUE) {
-        ESP_LOGE(PSQ4_TEMPERATURE_TAG, "FATAL: Failed to release temperature consumer mutex");
-        esp_restart();
+    if (err == ESP_OK) err = nvs_commit(nvs);
+    nvs_close(nvs);
+    return err;
+}
+
+
+esp_err_t psq4_temperature_set_filter(uint8_t sensor_id, const char *spec)
+{
+    psq4_temperature_filter_change_t change = { .sensor_id = sensor_id };
+    bool is_default = strcmp(spec, PSQ4_TEMPERATURE_DEFAULT_FILTER) == 0;
+    char canonical[PSQ4_FILTER_SPEC_MAX];
+    if (sensor_id >= PSQ4_TEMPERATURE_MAX_SENSORS) return ESP_ERR_INVALID_ARG;
+    if (is_default) {
+        change.filter = psq4_smoothing_default_filter;
+    } else if (!psq4_filter_chain_parse(spec, &change.filter)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (psq4_filter_chain_format(&change.filter, canonical, sizeof(canonical)) >= sizeof(canonical)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(psq4_temperature_filters_mutex, portMAX_DELAY);
+    esp_err_t err = ESP_ERR_TIMEOUT;
+    if (xQueueSend(psq4_temperature_filter_changes, &change, 0) == pdTRUE) {
+        psq4_temperature_filters[sensor_id] = change.filter;
+        ESP_LOGI(PSQ4_TEMPERATURE_TAG, "Sensor %u filter: %s", sensor_id, canonical);
+        err = psq4_temperature_save_filter(sensor_id, is_default ? NULL : canonical);
+    }
+    xSemaphoreGive(psq4_temperature_filters_mutex);
+    return err;
+}
+
+
+// Restores each sensor's filter chain from NVS, or the default
+static void psq4_temperature_load_filters()
+{
+    nvs_handle_t nvs;
+    bool opened = nvs_open(PSQ4_TEMPERATURE_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK;
+    for (uint8_t i = 0; i < PSQ4_TEMPERATURE_MAX_SENSORS; i++) {
+        char key[NVS_KEY_NAME_MAX_SIZE];
+        char spec[PSQ4_FILTER_SPEC_MAX];
+        size_t length = sizeof(spec);
+        snprintf(key, sizeof(key), PSQ4_TEMPERATURE_FILTER_KEY, i);
+        psq4_temperature_filters[i] = psq4_smoothing_default_filter;
+        if (!opened || nvs_get_str(nvs, key, spec, &length) != ESP_OK) continue;
+        if (psq4_filter_chain_parse(spec, &psq4_temperature_filters[i])) {
+            ESP_LOGI(PSQ4_TEMPERATURE_TAG, "Sensor %u filter: %s", i, spec);
+        } else {
+            ESP_LOGW(PSQ4_TEMPERATURE_TAG, "Ignoring bad filter for sensor %u: %s", i, spec);
+            psq4_temperature_filters[i] = psq4_smoothing_default_filter;
+        }
+    }
+    if (opened) nvs_close(nvs);
+}
+
+
+// filter [<sensor id> <spec>|default]
+static void psq4_temperature_filter_command(int argc, char **argv)
+{
+    if (argc == 1) {
+        char spec[PSQ4_FILTER_SPEC_MAX];
+        for (uint8_t i = 0; i < PSQ4_TEMPERATURE_MAX_SENSORS; i++) {
+            xSemaphoreTake(psq4_temperature_filters_mutex, portMAX_DELAY);
+            psq4_filter_chain_format(&psq4_temperature_filters[i], spec, sizeof(spec));
+            xSemaphoreGive(psq4_temperature_filters_mutex);
+            printf("%u %s\n", i, spec);
+        }
+        return;
+    }
+    char *end;
+    unsigned long sensor_id = strtoul(argv[1], &end, 10);
+    if (argc != 3 || *end != '\0' || end == argv[1] || sensor_id > UINT8_MAX) {
+        ESP_LOGW(PSQ4_TEMPERATURE_TAG, "Usage: filter [<sensor id> <spec>|default]");
+        return;
+    }
+    esp_err_t err = psq4_temperature_set_filter(sensor_id, argv[2]);
+    if (err != ESP_OK) {
+        ESP_LOGW(PSQ4_TEMPERATURE_TAG, "Failed to set filter: %s", esp_err_to_name(err));
     }
-    return result;
 }
 
 
 void psq4_temperature_init(EventGroupHandle_t system_event_group) {
-    psq4_temperature_consumer_mutex = xSemaphoreCreateMutex();
-    if (psq4_temperature_consumer_mutex == NULL) {
-        ESP_LOGE(PSQ4_TEMPERATURE_TAG, "FATAL: Failed to create temperature consumer mutex");
+    psq4_temperature_filters_mutex = PSQ4_MUTEX_CREATE();
+    psq4_temperature_filter_changes = PSQ4_QUEUE_CREATE(
+        PSQ4_TEMPERATURE_MAX_SENSORS,
+        sizeof(psq4_temperature_filter_change_t)
+    );
+    if (psq4_temperature_filters_mutex == NULL || psq4_temperature_filter_changes == NULL) {
+        ESP_LOGE(PSQ4_TEMPERATURE_TAG, "FATAL: Failed to create filter mutex or queue");
+        esp_restart();
+    }
+    psq4_temperature_load_filters();
+    psq4_console_register(
+        "filter",
+        "[<sensor id> <spec>|default] - show or set smoothing filters",
+        &psq4_temperature_filter_command
+    );
+    psq4_temperature_bus_events = PSQ4_EVENT_GROUP_CREATE();
+    if (psq4_temperature_bus_events == NULL) {
+        ESP_LOGE(PSQ4_TEMPERATURE_TAG, "FATAL: Failed to create temperature bus event group");
         esp_restart();
     }
     psq4_temperature_sensor.name = "External sensor";
@@ -280,7 +705,8 @@ void psq4_temperature_init(EventGroupHandle_t system_event_group) {
     psq4_temperature_sensor.rx_channel = RMT_CHANNEL_1;
     psq4_temperature_sensor.resolution = DS18B20_RESOLUTION_12_BIT;
     psq4_temperature_sensor.event_group = system_event_group;
-    xTaskCreate(
+    psq4_temperature_sensor.device_count = 0;
+    PSQ4_TASK_CREATE(
         &psq4_temperature_distribute,
         "distributeTemperatureTask",
         2048,
@@ -288,10 +714,10 @@ void psq4_temperature_init(EventGroupHandle_t system_event_group) {
         5,
         &psq4_temperature_distribute_task
     );
-    xTaskCreate(
+    PSQ4_TASK_CREATE(
         &psq4_temperature_sense,
         "senseTemperatureTask",
-        2048,
+        3072,
         &psq4_temperature_sensor,
         5,
         NULL
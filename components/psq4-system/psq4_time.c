@@ -32,6 +32,7 @@
 #include <esp_sntp.h>
 #include <ds3231.h>
 #include "psq4_constants.h"
+#include "psq4_rtos.h"
 
 
 // We read to whole second resolution, meaning that at the moment we get
@@ -209,5 +210,5 @@ void psq4_time_task(void *ignored)
 void psq4_time_init(EventGroupHandle_t system_event_group)
 {
    event_group = system_event_group;
-    xTaskCreate(&psq4_time_task, "timeTask", 2048, system, 5, NULL);
+    PSQ4_TASK_CREATE(&psq4_time_task, "timeTask", 2048, system, 5, NULL);
 }
@@ -0,0 +1,168 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_trace.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <xtensa/hal.h>
+#include <esp_log.h>
+#include <esp_ipc.h>
+#include <esp_timer.h>
+#include <esp32/clk.h>
+#include "psq4_console.h"
+
+
+#if CONFIG_PSQ4_TRACE_EVENTS & (CONFIG_PSQ4_TRACE_EVENTS - 1)
+#error "PSQ4_TRACE_EVENTS must be a power of two"
+#endif
+
+#define TRACE_LINE_PREFIX "psq4-trace"
+#define TRACE_COMMAND "trace"
+
+
+typedef struct {
+    /** @brief One more than the event's index, 0 while being written */
+    uint32_t stamp;
+    uint32_t ccount;
+    const char *name;
+    TaskHandle_t task;
+    uint32_t arg;
+    char phase;
+} psq4_trace_event_t;
+
+
+// A cycle count and the microseconds since boot at the same moment, by
+// which a core's cycle counts are converted to times comparable across
+// cores. Cycle counters wrap every few seconds and are not synchronized.
+typedef struct {
+    uint32_t ccount;
+    int64_t us;
+} psq4_trace_reference_t;
+
+
+static psq4_trace_event_t rings[portNUM_PROCESSORS][CONFIG_PSQ4_TRACE_EVENTS];
+// Indexes of the next event to be written, which only ever increase
+static uint32_t heads[portNUM_PROCESSORS];
+static bool recording = true;
+
+
+void psq4_trace_record(char phase, const char *name, uint32_t arg)
+{
+    if (!__atomic_load_n(&recording, __ATOMIC_RELAXED)) return;
+
+    // Claim a slot and read the cycle count with interrupts masked, so
+    // that neither happens on another core and every ring is in cycle
+    // count order. Preempting tasks then fill their slots without waiting
+    // for preempted ones to finish theirs.
+    UBaseType_t interrupts = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t core = xPortGetCoreID();
+    uint32_t index = heads[core];
+    uint32_t ccount = xthal_get_ccount();
+    __atomic_store_n(&heads[core], index + 1, __ATOMIC_RELAXED);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(interrupts);
+
+    psq4_trace_event_t *event = &rings[core][index & (CONFIG_PSQ4_TRACE_EVENTS - 1)];
+    __atomic_store_n(&event->stamp, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->ccount = ccount;
+    event->name = name;
+    event->task = xTaskGetCurrentTaskHandle();
+    event->arg = arg;
+    event->phase = phase;
+    __atomic_store_n(&event->stamp, index + 1, __ATOMIC_RELEASE);
+}
+
+
+static void capture_reference(void *arg)
+{
+    psq4_trace_reference_t *reference = (psq4_trace_reference_t *) arg;
+    reference->ccount = xthal_get_ccount();
+    reference->us = esp_timer_get_time();
+}
+
+
+static void dump_core(uint32_t core)
+{
+    psq4_trace_reference_t reference;
+    esp_ipc_call_blocking(core, capture_reference, &reference);
+    printf(
+        TRACE_LINE_PREFIX "\tcore\t%u\t%u\t%lld\n",
+        core,
+        reference.ccount,
+        reference.us
+    );
+
+    uint32_t head = __atomic_load_n(&heads[core], __ATOMIC_ACQUIRE);
+    uint32_t index = head > CONFIG_PSQ4_TRACE_EVENTS ? head - CONFIG_PSQ4_TRACE_EVENTS : 0;
+    psq4_trace_event_t event;
+    for (; index != head; index++) {
+        const psq4_trace_event_t *slot = &rings[core][index & (CONFIG_PSQ4_TRACE_EVENTS - 1)];
+        event = *slot;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        // Skip events torn by a task that was recording as the dump began
+        if (event.stamp != index + 1 || __atomic_load_n(&slot->stamp, __ATOMIC_RELAXED) != index + 1) {
+            continue;
+        }
+        printf(
+            TRACE_LINE_PREFIX "\tevent\t%u\t%u\t%c\t%s\t%s\t%u\n",
+            core,
+            event.ccount,
+            event.phase,
+            pcTaskGetTaskName(event.task),
+            event.name,
+            event.arg
+        );
+    }
+}
+
+
+void psq4_trace_dump()
+{
+    __atomic_store_n(&recording, false, __ATOMIC_RELAXED);
+    // Give events being recorded the chance to complete
+    vTaskDelay(1);
+    printf(TRACE_LINE_PREFIX "\tbegin\t%d\n", esp_clk_cpu_freq());
+    for (uint32_t core = 0; core < portNUM_PROCESSORS; core++) {
+        dump_core(core);
+    }
+    printf(TRACE_LINE_PREFIX "\tend\n");
+    fflush(stdout);
+    __atomic_store_n(&recording, true, __ATOMIC_RELAXED);
+}
+
+
+static void trace_command(int argc, char **argv)
+{
+    psq4_trace_dump();
+}
+
+
+void psq4_trace_init()
+{
+    psq4_console_register(TRACE_COMMAND, "- print the trace rings", &trace_command);
+}
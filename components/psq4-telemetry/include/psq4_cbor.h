@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_CBOR_H
+#define PSQ4_CBOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Writes CBOR (RFC 7049) items into a caller-supplied buffer
+ *
+ * Only what telemetry needs is supported: integers, text,
+ * and definite-length arrays and maps. Nothing is allocated.
+ * Writes that don't fit set overflow and are otherwise
+ * ignored, so check it once after writing everything.
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    /** @brief Bytes written so far */
+    size_t len;
+    /** @brief Set if any write did not fit */
+    bool overflow;
+} psq4_cbor_writer_t;
+
+
+/** @brief Start writing at the beginning of buf */
+void psq4_cbor_init(psq4_cbor_writer_t *writer, uint8_t *buf, size_t size);
+
+
+/** @brief Write an unsigned integer */
+void psq4_cbor_put_uint(psq4_cbor_writer_t *writer, uint32_t value);
+
+
+/** @brief Write a signed integer */
+void psq4_cbor_put_int(psq4_cbor_writer_t *writer, int32_t value);
+
+
+/** @brief Write a text string of len bytes of UTF-8 */
+void psq4_cbor_put_text(psq4_cbor_writer_t *writer, const char *text, size_t len);
+
+
+/** @brief Begin an array, to be followed by count items */
+void psq4_cbor_put_array(psq4_cbor_writer_t *writer, uint32_t count);
+
+
+/** @brief Begin a map, to be followed by count key/value item pairs */
+void psq4_cbor_put_map(psq4_cbor_writer_t *writer, uint32_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_CBOR_H
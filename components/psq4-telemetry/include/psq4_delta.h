@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_DELTA_H
+#define PSQ4_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <psq4_constants.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/** @brief Version byte that begins every encoded series */
+#define PSQ4_DELTA_VERSION 1
+
+
+/**
+ * @brief Compresses a series of samples into a caller-supplied buffer
+ *
+ * The series begins with the version byte and the sample
+ * count as a varint. Each sample is then three varints:
+ *
+ * - the sensor id
+ * - the timestamp: absolute for the first sample, then
+ *   zigzagged, a delta for the second and the change in
+ *   delta (delta-of-delta) thereafter
+ * - the temperature in hundredths of a degree C,
+ *   zigzagged: absolute for a sensor's first sample in
+ *   the series, otherwise a delta from its previous one
+ *
+ * Varints are little-endian base 128, as in Protocol
+ * Buffers. Samples at a steady rate with small changes
+ * take three bytes each. Writes that don't fit set
+ * overflow and are otherwise ignored.
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    /** @brief Bytes written so far */
+    size_t len;
+    /** @brief Set if any write did not fit */
+    bool overflow;
+    uint32_t samples;
+    uint32_t last_timestamp;
+    int32_t last_delta;
+    uint32_t sensors_seen;
+    int32_t last_values[PSQ4_TEMPERATURE_MAX_SENSORS];
+} psq4_delta_encoder_t;
+
+
+/** @brief Start a series of count samples at the beginning of buf */
+void psq4_delta_init(psq4_delta_encoder_t *encoder, uint8_t *buf, size_t size, uint32_t count);
+
+
+/** @brief Append a sample, sensor_id being below PSQ4_TEMPERATURE_MAX_SENSORS */
+void psq4_delta_put(
+    psq4_delta_encoder_t *encoder,
+    uint32_t timestamp,
+    uint8_t sensor_id,
+    int32_t centi_degrees
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_DELTA_H
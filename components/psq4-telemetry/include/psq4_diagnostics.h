@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_DIAGNOSTICS_H
+#define PSQ4_DIAGNOSTICS_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/** @brief Most tasks reported on in a diagnostics message */
+#define PSQ4_DIAGNOSTICS_MAX_TASKS 32
+
+
+/**
+ * @brief Start periodically publishing runtime diagnostics
+ *
+ * Every CONFIG_PSQ4_DIAGNOSTICS_SECONDS a CBOR map is published,
+ * at QoS 0, to data/pipsqueak/v4/diagnostics/<thing name>:
+ *
+ *     {
+ *       "time": epoch seconds, or 0 until the clock is set,
+ *       "uptime": seconds since boot,
+ *       "heap": [free, minimum free, largest free block],
+ *       "sampling": [[jitter histogram], [overrun histogram]],
+ *       "pipeline": [samples, overflows, high water, published],
+ *       "journal": [capacity, unsent, unsent erased],
+ *       "tasks": [[name, stack high-water mark, CPU], ...]
+ *     }
+ *
+ * The pipeline counts readings handed from sensing to smoothing since
+ * boot, readings dropped because smoothing fell behind, the most ever
+ * waiting to be smoothed at once, and smoothed samples published; see
+ * psq4_temperature_stats_t. The journal figures are in records. Unsent records erased since
+ * boot, to make room for newer ones while the broker was unreachable,
+ * are telemetry lost for good.
+ *
+ * The sampling histograms count temperature sweeps since boot, by
+ * how far the time since the previous sweep strayed from the sampling
+ * period and by how far sweeps that outlasted the period did so; see
+ * psq4_temperature_stats_t for their buckets.
+ *
+ * Heap figures and stack high-water marks are in bytes; a task's
+ * high-water mark is the least stack it has ever had to spare.
+ * CPU is the task's share of one core over the last period, in
+ * tenths of a percent, and is omitted unless FreeRTOS run time
+ * stats are enabled.
+ */
+void psq4_diagnostics_init();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_DIAGNOSTICS_H
@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_JOURNAL_H
+#define PSQ4_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <freertos/FreeRTOS.h>
+#include <esp_err.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/** @brief Label of the data partition holding the telemetry journal */
+#define PSQ4_JOURNAL_PARTITION_LABEL "journal"
+
+
+/**
+ * @brief A telemetry datapoint as stored in flash
+ *
+ * Records are 16 bytes, so they never straddle a flash
+ * sector. A record is sent once its sent byte has been
+ * programmed from 0xFF to 0x00, which flash permits in
+ * place without an erase.
+ */
+typedef struct {
+    /** @brief Position in the journal, 0xFFFFFFFF when blank */
+    uint32_t seq;
+    /** @brief Epoch seconds at which the sample was recorded */
+    uint32_t timestamp;
+    /** @brief Temperature in degrees C */
+    float value;
+    /** @brief Identifies the sensor that produced the sample */
+    uint8_t sensor_id;
+    /** @brief 0xFF until forwarded, then 0x00 */
+    uint8_t sent;
+    /** @brief Fletcher-16 over the fields above, less sent */
+    uint16_t check;
+} psq4_journal_record_t;
+
+
+/** @brief Journal counters, for diagnostics */
+typedef struct {
+    /** @brief Records the journal can hold */
+    uint32_t capacity;
+    /** @brief Records appended but not yet forwarded */
+    uint32_t pending;
+    /**
+     * @brief Unsent records erased to make room for new ones
+     *        since boot, each logged as a warning when it happens
+     */
+    uint32_t dropped;
+} psq4_journal_stats_t;
+
+
+/**
+ * @brief Open the journal, recovering any records
+ *        left unsent before the last restart
+ */
+void psq4_journal_init();
+
+
+/** @brief Durably append a record, assigning its seq */
+esp_err_t psq4_journal_append(psq4_journal_record_t *record);
+
+
+/**
+ * @brief Wait for the oldest unsent records
+ *
+ * Waits until *count records are unsent or the wait times
+ * out, then reads as many of the oldest as are available,
+ * up to *count. The records stay the oldest until
+ * psq4_journal_ack() is called for them, so each is
+ * forwarded at least once.
+ *
+ * @param records Receives the records, oldest first
+ * @param count The records wanted, then the records read
+ * @return ESP_OK if at least one record was read,
+ *         otherwise ESP_ERR_TIMEOUT
+ */
+esp_err_t psq4_journal_peek(
+    psq4_journal_record_t *records,
+    size_t *count,
+    TickType_t xTicksToWait
+);
+
+
+/** @brief Mark records returned by psq4_journal_peek() as sent */
+esp_err_t psq4_journal_ack(const psq4_journal_record_t *records, size_t count);
+
+
+/** @brief Obtain a snapshot of the journal counters */
+void psq4_journal_get_stats(psq4_journal_stats_t *stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_JOURNAL_H
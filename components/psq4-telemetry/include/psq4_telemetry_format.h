@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_TELEMETRY_FORMAT_H
+#define PSQ4_TELEMETRY_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sdkconfig.h>
+#include "psq4_journal.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Topics and payload bounds of the configured payload format
+// (PSQ4_TELEMETRY_FORMAT). Topic templates take the thing name.
+
+#if CONFIG_PSQ4_TELEMETRY_FORMAT_CBOR
+#define PSQ4_TELEMETRY_TOPIC_TEMPLATE "data/pipsqueak/v4/telemetry/%s/cbor"
+// Each sample is an array of timestamp, sensor and centi-degrees C: an
+// array head, a uint of up to 5 bytes, one of up to 2 and an int of up to 5
+#define PSQ4_TELEMETRY_CBOR_SAMPLE_MAX 13
+// Samples are published as a CBOR array
+#define PSQ4_TELEMETRY_PAYLOAD_MAX (3 + CONFIG_PSQ4_TELEMETRY_BATCH_SIZE * PSQ4_TELEMETRY_CBOR_SAMPLE_MAX)
+#elif CONFIG_PSQ4_TELEMETRY_FORMAT_DELTA
+#define PSQ4_TELEMETRY_TOPIC_TEMPLATE "data/pipsqueak/v4/telemetry/%s/delta"
+// Each sample is three varints, of up to 1, 5 and 5 bytes
+#define PSQ4_TELEMETRY_DELTA_SAMPLE_MAX 11
+// After a version byte and a varint sample count
+#define PSQ4_TELEMETRY_PAYLOAD_MAX (6 + CONFIG_PSQ4_TELEMETRY_BATCH_SIZE * PSQ4_TELEMETRY_DELTA_SAMPLE_MAX)
+#else
+#define PSQ4_TELEMETRY_TOPIC_TEMPLATE "data/pipsqueak/v4/telemetry/%s"
+// Longest a JSON sample can reasonably be, with its separator
+#define PSQ4_TELEMETRY_JSON_SAMPLE_MAX 80
+// Samples are published as a JSON array
+#define PSQ4_TELEMETRY_PAYLOAD_MAX (2 + CONFIG_PSQ4_TELEMETRY_BATCH_SIZE * PSQ4_TELEMETRY_JSON_SAMPLE_MAX)
+#endif
+
+
+/**
+ * @brief Encode a batch of journaled samples in the configured format
+ *
+ * @param payload Receives the payload, which needs room for
+ *        PSQ4_TELEMETRY_PAYLOAD_MAX + 1 bytes (JSON is terminated)
+ * @param count At most CONFIG_PSQ4_TELEMETRY_BATCH_SIZE
+ * @return The payload length in bytes
+ */
+size_t psq4_telemetry_render(
+    uint8_t *payload,
+    const psq4_journal_record_t *records,
+    size_t count
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSQ4_TELEMETRY_FORMAT_H
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_cbor.h"
+
+#include <string.h>
+
+
+#define PSQ4_CBOR_MAJOR_UINT  0x00
+#define PSQ4_CBOR_MAJOR_NINT  0x20
+#define PSQ4_CBOR_MAJOR_TEXT  0x60
+#define PSQ4_CBOR_MAJOR_ARRAY 0x80
+#define PSQ4_CBOR_MAJOR_MAP   0xA0
+// Additional information values announcing a 1, 2 or 4 byte argument
+#define PSQ4_CBOR_ARG_8       24
+#define PSQ4_CBOR_ARG_16      25
+#define PSQ4_CBOR_ARG_32      26
+
+
+void psq4_cbor_init(psq4_cbor_writer_t *writer, uint8_t *buf, size_t size)
+{
+    writer->buf = buf;
+    writer->size = size;
+    writer->len = 0;
+    writer->overflow = false;
+}
+
+
+static bool psq4_cbor__reserve(psq4_cbor_writer_t *writer, size_t len)
+{
+    if (writer->overflow || writer->size - writer->len < len) {
+        writer->overflow = true;
+        return false;
+    }
+    return true;
+}
+
+
+// Writes an item head: the major type and its argument in the fewest bytes
+static void psq4_cbor__put_head(psq4_cbor_writer_t *writer, uint8_t major, uint32_t arg)
+{
+    uint8_t *out;
+    if (arg < PSQ4_CBOR_ARG_8) {
+        if (!psq4_cbor__reserve(writer, 1)) return;
+        writer->buf[writer->len++] = major | arg;
+    } else if (arg <= 0xFF) {
+        if (!psq4_cbor__reserve(writer, 2)) return;
+        out = writer->buf + writer->len;
+        out[0] = major | PSQ4_CBOR_ARG_8;
+        out[1] = arg;
+        writer->len += 2;
+    } else if (arg <= 0xFFFF) {
+        if (!psq4_cbor__reserve(writer, 3)) return;
+        out = writer->buf + writer->len;
+        out[0] = major | PSQ4_CBOR_ARG_16;
+        out[1] = arg >> 8;
+        out[2] = arg;
+        writer->len += 3;
+    } else {
+        if (!psq4_cbor__reserve(writer, 5)) return;
+        out = writer->buf + writer->len;
+        out[0] = major | PSQ4_CBOR_ARG_32;
+        out[1] = arg >> 24;
+        out[2] = arg >> 16;
+        out[3] = arg >> 8;
+        out[4] = arg;
+        writer->len += 5;
+    }
+}
+
+
+void psq4_cbor_put_uint(psq4_cbor_writer_t *writer, uint32_t value)
+{
+    psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_UINT, value);
+}
+
+
+void psq4_cbor_put_int(psq4_cbor_writer_t *writer, int32_t value)
+{
+    if (value >= 0) {
+        psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_UINT, (uint32_t) value);
+    } else {
+        // Negative integers are encoded as -1 - n
+        psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_NINT, (uint32_t) (-1 - value));
+    }
+}
+
+
+void psq4_cbor_put_text(psq4_cbor_writer_t *writer, const char *text, size_t len)
+{
+    psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_TEXT, len);
+    if (!psq4_cbor__reserve(writer, len)) return;
+    memcpy(writer->buf + writer->len, text, len);
+    writer->len += len;
+}
+
+
+void psq4_cbor_put_array(psq4_cbor_writer_t *writer, uint32_t count)
+{
+    psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_ARRAY, count);
+}
+
+
+void psq4_cbor_put_map(psq4_cbor_writer_t *writer, uint32_t count)
+{
+    psq4_cbor__put_head(writer, PSQ4_CBOR_MAJOR_MAP, count);
+}
@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_delta.h"
+
+
+static bool psq4_delta__reserve(psq4_delta_encoder_t *encoder, size_t len)
+{
+    if (encoder->overflow || encoder->size - encoder->len < len) {
+        encoder->overflow = true;
+        return false;
+    }
+    return true;
+}
+
+
+static void psq4_delta__put_varint(psq4_delta_encoder_t *encoder, uint32_t value)
+{
+    uint8_t bytes[5];
+    size_t len = 0;
+    do {
+        bytes[len] = value & 0x7F;
+        value >>= 7;
+        if (value) bytes[len] |= 0x80;
+        len++;
+    } while (value);
+    if (!psq4_delta__reserve(encoder, len)) return;
+    for (size_t i = 0; i < len; i++) {
+        encoder->buf[encoder->len++] = bytes[i];
+    }
+}
+
+
+// Maps signed to unsigned so that small magnitudes stay small:
+// 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+static void psq4_delta__put_zigzag(psq4_delta_encoder_t *encoder, int32_t value)
+{
+    psq4_delta__put_varint(encoder, ((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+}
+
+
+void psq4_delta_init(psq4_delta_encoder_t *encoder, uint8_t *buf, size_t size, uint32_t count)
+{
+    encoder->buf = buf;
+    encoder->size = size;
+    encoder->len = 0;
+    encoder->overflow = false;
+    encoder->samples = 0;
+    encoder->last_timestamp = 0;
+    encoder->last_delta = 0;
+    encoder->sensors_seen = 0;
+    if (psq4_delta__reserve(encoder, 1)) {
+        encoder->buf[encoder->len++] = PSQ4_DELTA_VERSION;
+    }
+    psq4_delta__put_varint(encoder, count);
+}
+
+
+void psq4_delta_put(
+    psq4_delta_encoder_t *encoder,
+    uint32_t timestamp,
+    uint8_t sensor_id,
+    int32_t centi_degrees)
+{
+    psq4_delta__put_varint(encoder, sensor_id);
+
+    if (encoder->samples == 0) {
+        psq4_delta__put_varint(encoder, timestamp);
+    } else {
+        // Differences wrap modulo 2^32, as the decoder's sums do
+        int32_t delta = (int32_t) (timestamp - encoder->last_timestamp);
+        psq4_delta__put_zigzag(
+            encoder,
+            encoder->samples == 1 ? delta : (int32_t) ((uint32_t) delta - (uint32_t) encoder->last_delta)
+        );
+        encoder->last_delta = delta;
+    }
+    encoder->last_timestamp = timestamp;
+
+    uint32_t sensor_bit = 1 << sensor_id;
+    if (encoder->sensors_seen & sensor_bit) {
+        psq4_delta__put_zigzag(
+            encoder,
+            (int32_t) ((uint32_t) centi_degrees - (uint32_t) encoder->last_values[sensor_id])
+        );
+    } else {
+        psq4_delta__put_zigzag(encoder, centi_degrees);
+        encoder->sensors_seen |= sensor_bit;
+    }
+    encoder->last_values[sensor_id] = centi_degrees;
+
+    encoder->samples++;
+}
@@ -0,0 +1,242 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_diagnostics.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <sdkconfig.h>
+#include <aws_iot_mqtt_client_interface.h>
+#include <psq4_system.h>
+#include <psq4_aws_iot.h>
+#include <psq4_rtos.h>
+#include "psq4_cbor.h"
+#include "psq4_journal.h"
+
+
+#define DIAGNOSTICS_TOPIC_TEMPLATE "data/pipsqueak/v4/diagnostics/%s"
+// Each task is an array head, a name of up to configMAX_TASK_NAME_LEN
+// bytes with its head, a uint of up to 5 bytes and one of up to 3
+#define DIAGNOSTICS_TASK_MAX (1 + 1 + configMAX_TASK_NAME_LEN + 5 + 3)
+// The sampling key, then an array head and two histograms of uints of
+// up to 5 bytes, each with its head
+#define DIAGNOSTICS_SAMPLING_MAX (9 + 1 + 2 * (1 + PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS * 5))
+// The pipeline key, then an array head and four uints of up to 5 bytes
+#define DIAGNOSTICS_PIPELINE_MAX (9 + 1 + 4 * 5)
+// The journal key, then an array head and three uints of up to 5 bytes
+#define DIAGNOSTICS_JOURNAL_MAX (8 + 1 + 3 * 5)
+// The map, its keys, timestamps and heap figures take under 64 bytes
+#define DIAGNOSTICS_PAYLOAD_MAX ( \
+    64 + \
+    DIAGNOSTICS_SAMPLING_MAX + \
+    DIAGNOSTICS_PIPELINE_MAX + \
+    DIAGNOSTICS_JOURNAL_MAX + \
+    PSQ4_DIAGNOSTICS_MAX_TASKS * DIAGNOSTICS_TASK_MAX \
+)
+
+// The MQTT client serializes the topic and payload together into its transmit buffer
+#if CONFIG_AWS_IOT_MQTT_TX_BUF_LEN < DIAGNOSTICS_PAYLOAD_MAX + 256
+#error "Diagnostics may not fit the MQTT transmit buffer; increase AWS_IOT_MQTT_TX_BUF_LEN"
+#endif
+
+
+static const char * PSQ4_DIAGNOSTICS_TAG = "psq4-diagnostics";
+
+
+static TaskStatus_t tasks[PSQ4_DIAGNOSTICS_MAX_TASKS];
+static psq4_temperature_stats_t temperature_stats;
+static psq4_journal_stats_t journal_stats;
+static uint8_t payload[DIAGNOSTICS_PAYLOAD_MAX];
+
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+
+// Run time counters as of the last report, by task number
+static struct {
+    UBaseType_t task_number;
+    uint32_t run_time;
+} last_run_times[PSQ4_DIAGNOSTICS_MAX_TASKS];
+static size_t last_run_times_count;
+static uint32_t last_total_run_time;
+
+
+// Returns a task's run time counter as of the last report, or 0 for
+// tasks created since
+static uint32_t last_run_time(UBaseType_t task_number)
+{
+    for (size_t i = 0; i < last_run_times_count; i++) {
+        if (last_run_times[i].task_number == task_number) {
+            return last_run_times[i].run_time;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+
+// Encodes a snapshot of tasks and the heap, returning its length
+static size_t render_diagnostics()
+{
+    uint32_t total_run_time = 0;
+    UBaseType_t count = uxTaskGetSystemState(tasks, PSQ4_DIAGNOSTICS_MAX_TASKS, &total_run_time);
+    if (count == 0) {
+        // Returned when there are more tasks than PSQ4_DIAGNOSTICS_MAX_TASKS
+        ESP_LOGW(
+            PSQ4_DIAGNOSTICS_TAG,
+            "Too many tasks to report on (%d)",
+            uxTaskGetNumberOfTasks()
+        );
+    }
+
+    time_t now = 0;
+    if (psq4_system_await_clock(0) == ESP_OK) {
+        now = psq4_system_time();
+    }
+
+    psq4_cbor_writer_t writer;
+    psq4_cbor_init(&writer, payload, DIAGNOSTICS_PAYLOAD_MAX);
+    psq4_cbor_put_map(&writer, 7);
+
+    psq4_cbor_put_text(&writer, "time", 4);
+    psq4_cbor_put_uint(&writer, (uint32_t) now);
+    psq4_cbor_put_text(&writer, "uptime", 6);
+    psq4_cbor_put_uint(&writer, (uint32_t) (esp_timer_get_time() / 1000000));
+
+    psq4_cbor_put_text(&writer, "heap", 4);
+    psq4_cbor_put_array(&writer, 3);
+    psq4_cbor_put_uint(&writer, heap_caps_get_free_size(MALLOC_CAP_8BIT));
+    psq4_cbor_put_uint(&writer, heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+    psq4_cbor_put_uint(&writer, heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+
+    psq4_temperature_get_stats(&temperature_stats);
+    psq4_cbor_put_text(&writer, "sampling", 8);
+    psq4_cbor_put_array(&writer, 2);
+    psq4_cbor_put_array(&writer, PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS);
+    for (size_t i = 0; i < PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS; i++) {
+        psq4_cbor_put_uint(&writer, temperature_stats.jitter[i]);
+    }
+    psq4_cbor_put_array(&writer, PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS);
+    for (size_t i = 0; i < PSQ4_TEMPERATURE_HISTOGRAM_BUCKETS; i++) {
+        psq4_cbor_put_uint(&writer, temperature_stats.overruns[i]);
+    }
+
+    psq4_cbor_put_text(&writer, "pipeline", 8);
+    psq4_cbor_put_array(&writer, 4);
+    psq4_cbor_put_uint(&writer, temperature_stats.samples);
+    psq4_cbor_put_uint(&writer, temperature_stats.overflows);
+    psq4_cbor_put_uint(&writer, temperature_stats.high_water);
+    psq4_cbor_put_uint(&writer, temperature_stats.published);
+
+    psq4_journal_get_stats(&journal_stats);
+    psq4_cbor_put_text(&writer, "journal", 7);
+    psq4_cbor_put_array(&writer, 3);
+    psq4_cbor_put_uint(&writer, journal_stats.capacity);
+    psq4_cbor_put_uint(&writer, journal_stats.pending);
+    psq4_cbor_put_uint(&writer, journal_stats.dropped);
+
+    psq4_cbor_put_text(&writer, "tasks", 5);
+    psq4_cbor_put_array(&writer, count);
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    // Counters are 32 bits and wrap, but unsigned differences stay
+    // correct while reports are less than a wrap apart
+    uint32_t period = total_run_time - last_total_run_time;
+    last_total_run_time = total_run_time;
+#endif
+    for (UBaseType_t i = 0; i < count; i++) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        psq4_cbor_put_array(&writer, 3);
+#else
+        psq4_cbor_put_array(&writer, 2);
+#endif
+        psq4_cbor_put_text(&writer, tasks[i].pcTaskName, strlen(tasks[i].pcTaskName));
+        // Already in bytes, as a stack word is a byte on this port
+        psq4_cbor_put_uint(&writer, tasks[i].usStackHighWaterMark);
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        uint32_t run_time = tasks[i].ulRunTimeCounter - last_run_time(tasks[i].xTaskNumber);
+        psq4_cbor_put_uint(
+            &writer,
+            period > 0 ? (uint32_t) (((uint64_t) run_time * 1000) / period) : 0
+        );
+#endif
+    }
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    // Tasks deleted since are forgotten
+    for (UBaseType_t i = 0; i < count; i++) {
+        last_run_times[i].task_number = tasks[i].xTaskNumber;
+        last_run_times[i].run_time = tasks[i].ulRunTimeCounter;
+    }
+    last_run_times_count = count;
+#endif
+
+    // Can't happen while DIAGNOSTICS_TASK_MAX is right
+    assert(!writer.overflow);
+    return writer.len;
+}
+
+
+static void diagnostics_task(void *ignored)
+{
+    char topic[255];
+    if (strlen(CONFIG_AWS_IOT_THING_NAME) > 200) {
+      ESP_LOGE(
+          PSQ4_DIAGNOSTICS_TAG,
+          "FATAL: AWS IoT Thing name exceeds 200 characters in length"
+      );
+      abort();
+    }
+    sprintf(topic, DIAGNOSTICS_TOPIC_TEMPLATE, CONFIG_AWS_IOT_THING_NAME);
+
+    size_t payload_len;
+    esp_err_t err;
+    TickType_t last_wake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&last_wake, (CONFIG_PSQ4_DIAGNOSTICS_SECONDS * 1000) / portTICK_PERIOD_MS);
+        payload_len = render_diagnostics();
+        // A lost report is superseded by the next, so QoS 0 will do
+        err = psq4_mqtt_publish_async(topic, QOS0, payload, payload_len, NULL, NULL);
+        if (err != ESP_OK) {
+            ESP_LOGW(PSQ4_DIAGNOSTICS_TAG, "Diagnostics not sent: %s", esp_err_to_name(err));
+        }
+    }
+}
+
+
+void psq4_diagnostics_init()
+{
+    PSQ4_TASK_CREATE(
+        &diagnostics_task,
+        "diagnosticsTask",
+        3072,
+        NULL,
+        1,
+        NULL
+    );
+}
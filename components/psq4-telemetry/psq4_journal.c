@@ -0,0 +1,357 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_journal.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+#include <esp_spi_flash.h>
+#include <psq4_rtos.h>
+
+
+#define PSQ4_JOURNAL_BLANK_SEQ 0xFFFFFFFF
+#define PSQ4_JOURNAL_UNSENT 0xFF
+#define PSQ4_JOURNAL_SENT 0x00
+#define PSQ4_JOURNAL_SLOTS_PER_SECTOR (SPI_FLASH_SEC_SIZE / sizeof(psq4_journal_record_t))
+// Records read at a time while recovering
+#define PSQ4_JOURNAL_SCAN_BATCH 16
+
+
+static const char *PSQ4_JOURNAL_TAG = "psq4-journal";
+
+// The journal is a ring of fixed-size record slots. Slots are programmed
+// in order from the head, and the sector ahead of the head is erased on
+// entry, so the only writes to an erased slot are the record itself and
+// later its sent byte.
+static const esp_partition_t *psq4_journal_partition;
+static uint32_t psq4_journal_slot_count;
+static uint32_t psq4_journal_head;
+static uint32_t psq4_journal_tail;
+static uint32_t psq4_journal_next_seq;
+static psq4_journal_stats_t psq4_journal_stats;
+static SemaphoreHandle_t psq4_journal_mutex;
+static SemaphoreHandle_t psq4_journal_appended;
+
+
+static uint16_t psq4_journal_check(const psq4_journal_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *) record;
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (size_t i = 0; i < offsetof(psq4_journal_record_t, sent); i++) {
+        sum1 = (sum1 + bytes[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+
+static bool psq4_journal_valid(const psq4_journal_record_t *record)
+{
+    return record->seq != PSQ4_JOURNAL_BLANK_SEQ &&
+           record->check == psq4_journal_check(record);
+}
+
+
+static esp_err_t psq4_journal_read(uint32_t slot, psq4_journal_record_t *records, size_t count)
+{
+    return esp_partition_read(
+        psq4_journal_partition,
+        slot * sizeof(psq4_journal_record_t),
+        records,
+        count * sizeof(psq4_journal_record_t)
+    );
+}
+
+
+static uint32_t psq4_journal_advance(uint32_t slot)
+{
+    return (slot + 1) % psq4_journal_slot_count;
+}
+
+
+// Finds the newest record, which fixes the head, and the oldest unsent
+// record, which fixes the tail
+static void psq4_journal_recover()
+{
+    psq4_journal_record_t records[PSQ4_JOURNAL_SCAN_BATCH];
+    bool found = false;
+    uint32_t newest_seq = 0;
+    uint32_t newest_slot = 0;
+    uint32_t oldest_unsent_seq = PSQ4_JOURNAL_BLANK_SEQ;
+    uint32_t oldest_unsent_slot = 0;
+    uint32_t pending = 0;
+    for (uint32_t slot = 0; slot < psq4_journal_slot_count; slot += PSQ4_JOURNAL_SCAN_BATCH) {
+        ESP_ERROR_CHECK(psq4_journal_read(slot, records, PSQ4_JOURNAL_SCAN_BATCH));
+        for (size_t i = 0; i < PSQ4_JOURNAL_SCAN_BATCH; i++) {
+            if (!psq4_journal_valid(&records[i])) continue;
+            if (!found || records[i].seq > newest_seq) {
+                newest_seq = records[i].seq;
+                newest_slot = slot + i;
+                found = true;
+            }
+            if (records[i].sent == PSQ4_JOURNAL_UNSENT) {
+                pending++;
+                if (records[i].seq < oldest_unsent_seq) {
+                    oldest_unsent_seq = records[i].seq;
+                    oldest_unsent_slot = slot + i;
+                }
+            }
+        }
+    }
+    if (!found) {
+        // New, or never used by this firmware, so start from scratch
+        ESP_LOGI(PSQ4_JOURNAL_TAG, "Formatting journal partition");
+        ESP_ERROR_CHECK(esp_partition_erase_range(
+            psq4_journal_partition,
+            0,
+            psq4_journal_slot_count * sizeof(psq4_journal_record_t)
+        ));
+        psq4_journal_head = 0;
+        psq4_journal_next_seq = 0;
+    } else {
+        psq4_journal_head = psq4_journal_advance(newest_slot);
+        psq4_journal_next_seq = newest_seq + 1;
+    }
+    psq4_journal_stats.pending = pending;
+    psq4_journal_tail = pending > 0 ? oldest_unsent_slot : psq4_journal_head;
+    ESP_LOGI(
+        PSQ4_JOURNAL_TAG,
+        "Journal holds %d of %d records unsent",
+        pending,
+        psq4_journal_slot_count
+    );
+}
+
+
+void psq4_journal_init()
+{
+    psq4_journal_partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY,
+        PSQ4_JOURNAL_PARTITION_LABEL
+    );
+    if (psq4_journal_partition == NULL) {
+        ESP_LOGE(
+            PSQ4_JOURNAL_TAG,
+            "FATAL: No \"%s\" data partition, check the partition table",
+            PSQ4_JOURNAL_PARTITION_LABEL
+        );
+        abort();
+    }
+    psq4_journal_slot_count =
+        (psq4_journal_partition->size / SPI_FLASH_SEC_SIZE) * PSQ4_JOURNAL_SLOTS_PER_SECTOR;
+    if (psq4_journal_slot_count < 2 * PSQ4_JOURNAL_SLOTS_PER_SECTOR) {
+        ESP_LOGE(PSQ4_JOURNAL_TAG, "FATAL: Journal partition must span at least two sectors");
+        abort();
+    }
+    psq4_journal_stats.capacity = psq4_journal_slot_count;
+
+    psq4_journal_mutex = PSQ4_MUTEX_CREATE();
+    psq4_journal_appended = PSQ4_BINARY_SEMAPHORE_CREATE();
+    if (psq4_journal_mutex == NULL || psq4_journal_appended == NULL) {
+        ESP_LOGE(PSQ4_JOURNAL_TAG, "FATAL: Failed to create journal semaphores");
+        abort();
+    }
+
+    psq4_journal_recover();
+}
+
+
+// Erases the sector the head has just entered, giving up any unsent
+// records still in it
+static esp_err_t psq4_journal_erase_ahead()
+{
+    uint32_t sector_start = psq4_journal_head;
+    uint32_t sector_end = sector_start + PSQ4_JOURNAL_SLOTS_PER_SECTOR;
+    if (
+        psq4_journal_stats.pending > 0 &&
+        psq4_journal_tail >= sector_start &&
+        psq4_journal_tail < sector_end
+       )
+    {
+        uint32_t lost = sector_end - psq4_journal_tail;
+        if (lost > psq4_journal_stats.pending) lost = psq4_journal_stats.pending;
+        psq4_journal_stats.pending -= lost;
+        psq4_journal_stats.dropped += lost;
+        psq4_journal_tail = sector_end % psq4_journal_slot_count;
+        ESP_LOGW(
+            PSQ4_JOURNAL_TAG,
+            "Journal full, erased %d oldest unsent records, %d since boot",
+            lost,
+            psq4_journal_stats.dropped
+        );
+    }
+    return esp_partition_erase_range(
+        psq4_journal_partition,
+        sector_start * sizeof(psq4_journal_record_t),
+        SPI_FLASH_SEC_SIZE
+    );
+}
+
+
+esp_err_t psq4_journal_append(psq4_journal_record_t *record)
+{
+    psq4_journal_record_t slot_record;
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(psq4_journal_mutex, portMAX_DELAY);
+    while (true) {
+        if (psq4_journal_head % PSQ4_JOURNAL_SLOTS_PER_SECTOR == 0) {
+            err = psq4_journal_erase_ahead();
+            if (err != ESP_OK) break;
+        }
+        // Skip any slot left dirty by a write torn by a restart
+        err = psq4_journal_read(psq4_journal_head, &slot_record, 1);
+        if (err != ESP_OK || slot_record.seq == PSQ4_JOURNAL_BLANK_SEQ) break;
+        psq4_journal_head = psq4_journal_advance(psq4_journal_head);
+    }
+    if (err == ESP_OK) {
+        record->seq = psq4_journal_next_seq;
+        record->sent = PSQ4_JOURNAL_UNSENT;
+        record->check = psq4_journal_check(record);
+        err = esp_partition_write(
+            psq4_journal_partition,
+            psq4_journal_head * sizeof(psq4_journal_record_t),
+            record,
+            sizeof(psq4_journal_record_t)
+        );
+    }
+    if (err == ESP_OK) {
+        if (psq4_journal_stats.pending == 0) psq4_journal_tail = psq4_journal_head;
+        psq4_journal_stats.pending++;
+        psq4_journal_next_seq++;
+        psq4_journal_head = psq4_journal_advance(psq4_journal_head);
+    } else {
+        ESP_LOGE(PSQ4_JOURNAL_TAG, "Failed to append journal record: %s", esp_err_to_name(err));
+    }
+    xSemaphoreGive(psq4_journal_mutex);
+    if (err == ESP_OK) xSemaphoreGive(psq4_journal_appended);
+    return err;
+}
+
+
+// Skips the tail past any slots that are torn, which do not count as pending
+static esp_err_t psq4_journal_seek_tail(psq4_journal_record_t *record)
+{
+    esp_err_t err;
+    while (psq4_journal_stats.pending > 0) {
+        err = psq4_journal_read(psq4_journal_tail, record, 1);
+        if (err != ESP_OK) return err;
+        if (psq4_journal_valid(record) && record->sent == PSQ4_JOURNAL_UNSENT) return ESP_OK;
+        psq4_journal_tail = psq4_journal_advance(psq4_journal_tail);
+        if (psq4_journal_tail == psq4_journal_head) psq4_journal_stats.pending = 0;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+
+esp_err_t psq4_journal_peek(
+    psq4_journal_record_t *records,
+    size_t *count,
+    TickType_t ticks_to_wait)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t elapsed;
+    size_t wanted = *count;
+    bool timed_out = false;
+    esp_err_t err;
+    *count = 0;
+    while (true) {
+        xSemaphoreTake(psq4_journal_mutex, portMAX_DELAY);
+        if (psq4_journal_stats.pending >= wanted || (timed_out && psq4_journal_stats.pending > 0)) {
+            err = psq4_journal_seek_tail(&records[0]);
+            if (err == ESP_OK) {
+                *count = 1;
+                uint32_t slot = psq4_journal_tail;
+                while (*count < wanted && *count < psq4_journal_stats.pending) {
+                    slot = psq4_journal_advance(slot);
+                    if (slot == psq4_journal_head) break;
+                    err = psq4_journal_read(slot, &records[*count], 1);
+                    if (err != ESP_OK) break;
+                    if (psq4_journal_valid(&records[*count])) (*count)++;
+                }
+            }
+            xSemaphoreGive(psq4_journal_mutex);
+            if (*count > 0) return ESP_OK;
+            if (err != ESP_ERR_NOT_FOUND) return err;
+        } else {
+            xSemaphoreGive(psq4_journal_mutex);
+        }
+        if (timed_out) return ESP_ERR_TIMEOUT;
+        elapsed = xTaskGetTickCount() - start;
+        if (ticks_to_wait != portMAX_DELAY && elapsed >= ticks_to_wait) {
+            timed_out = true;
+        } else if (xSemaphoreTake(
+            psq4_journal_appended,
+            ticks_to_wait == portMAX_DELAY ? portMAX_DELAY : ticks_to_wait - elapsed) != pdTRUE)
+        {
+            timed_out = true;
+        }
+    }
+}
+
+
+esp_err_t psq4_journal_ack(const psq4_journal_record_t *records, size_t count)
+{
+    static const uint8_t sent = PSQ4_JOURNAL_SENT;
+    psq4_journal_record_t tail_record;
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(psq4_journal_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < count && err == ESP_OK; i++) {
+        err = psq4_journal_seek_tail(&tail_record);
+        if (err == ESP_OK && tail_record.seq != records[i].seq) {
+            // Dropped to make room while it was being forwarded
+            err = ESP_ERR_NOT_FOUND;
+        }
+        if (err == ESP_OK) {
+            err = esp_partition_write(
+                psq4_journal_partition,
+                psq4_journal_tail * sizeof(psq4_journal_record_t) + offsetof(psq4_journal_record_t, sent),
+                &sent,
+                sizeof(sent)
+            );
+        }
+        if (err == ESP_OK) {
+            psq4_journal_stats.pending--;
+            psq4_journal_tail = psq4_journal_stats.pending > 0
+                ? psq4_journal_advance(psq4_journal_tail)
+                : psq4_journal_head;
+        }
+    }
+    xSemaphoreGive(psq4_journal_mutex);
+    return err;
+}
+
+
+void psq4_journal_get_stats(psq4_journal_stats_t *stats)
+{
+    xSemaphoreTake(psq4_journal_mutex, portMAX_DELAY);
+    *stats = psq4_journal_stats;
+    xSemaphoreGive(psq4_journal_mutex);
+}
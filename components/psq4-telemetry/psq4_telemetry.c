@@ -24,6 +24,7 @@
 
 #include "psq4_telemetry.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -35,20 +36,69 @@
 #include <psq4_system.h>
 #include <psq4_constants.h>
 #include <psq4_aws_iot.h>
+#include <psq4_rtos.h>
+#include <psq4_trace.h>
+#include "psq4_journal.h"
+#include "psq4_telemetry_format.h"
 
 
-#define TELEMETRY_TOPIC_TEMPLATE "data/pipsqueak/v4/telemetry/%s"
-#define TELEMETRY_JSON_TEMPLATE "{\"timestamp\": %ld, \"temperature\": %.4f}"
+#if CONFIG_PSQ4_TELEMETRY_FORMAT_CBOR || CONFIG_PSQ4_TELEMETRY_FORMAT_DELTA
+// No float formatting, and so a much smaller stack
+#define TELEMETRY_TASK_STACK_SIZE 3072
+#else
+#define TELEMETRY_TASK_STACK_SIZE 9056
+#endif
+
+// The MQTT client serializes the topic and payload together into its transmit buffer
+#if CONFIG_AWS_IOT_MQTT_TX_BUF_LEN < PSQ4_TELEMETRY_PAYLOAD_MAX + 256
+#error "Telemetry batches may not fit the MQTT transmit buffer; increase AWS_IOT_MQTT_TX_BUF_LEN or reduce PSQ4_TELEMETRY_BATCH_SIZE"
+#endif
 
 
 static const char * PSQ4_TELEMETRY_TAG = "psq4-telemetry";
-static TaskHandle_t psq4_temperature_telemetry_task;
 
 
-static void temperature_telemetry_task(void *ignored)
+// Journals every sample as it arrives, whatever the state of the network
+static void temperature_journal_task(void *ignored)
 {
-    psq4_system_handle_t system = psq4_system();
+    // Reliable clock required for telemetry timestamps
+    psq4_system_await_clock(portMAX_DELAY);
+    TickType_t clock_ready = xTaskGetTickCount();
 
+    psq4_temperature_subscriber_t subscriber;
+    psq4_temperature_subscribe(&subscriber, UINT32_MAX, 0);
+
+    const psq4_temperature_sample_t *sample;
+    psq4_journal_record_t record;
+    esp_err_t wait_result;
+    while((wait_result = psq4_temperature_next(&subscriber, &sample, portMAX_DELAY)) == ESP_OK) {
+        // Samples are published some time after they are read, so a few
+        // may have been stamped before the clock could be relied upon
+        if ((int32_t) (sample->tick - clock_ready) < 0) continue;
+        record.timestamp = sample->timestamp;
+        record.value = sample->value;
+        record.sensor_id = sample->sensor_id;
+        PSQ4_TRACE_BEGIN("journal_append");
+        if (psq4_journal_append(&record) == ESP_OK) {
+            // Ends once the broker has acknowledged the sample
+            PSQ4_TRACE_ASYNC_BEGIN("sample", record.seq);
+        }
+        PSQ4_TRACE_END("journal_append");
+    };
+    ESP_LOGE(
+        PSQ4_TELEMETRY_TAG,
+        "FATAL: failed to receive temperature reading from distributor, code %d",
+        wait_result
+    );
+}
+
+
+// Forwards journaled samples oldest first, blocking while the broker is
+// unreachable. Samples are batched up to CONFIG_PSQ4_TELEMETRY_BATCH_SIZE
+// at a time, waiting at most CONFIG_PSQ4_TELEMETRY_BATCH_SECONDS for a
+// batch to fill.
+static void temperature_telemetry_task(void *ignored)
+{
     char topic[255];
     if (strlen(CONFIG_AWS_IOT_THING_NAME) > 200) {
       ESP_LOGE(
@@ -57,43 +107,69 @@ static void temperature_telemetry_task(void *ignored)
       );
       abort();
     }
-    sprintf(topic, TELEMETRY_TOPIC_TEMPLATE, CONFIG_AWS_IOT_THING_NAME);
-
-    // Reliable clock required for telemetry timestamps
-    psq4_system_await_clock(portMAX_DELAY);
+    sprintf(topic, PSQ4_TELEMETRY_TOPIC_TEMPLATE, CONFIG_AWS_IOT_THING_NAME);
 
-    time_t timestamp;
-    uint32_t notification_value;
-    float ewma_temperature;
-    char json[100];
-    BaseType_t wait_result;
-    while((wait_result = xTaskNotifyWait(0, 0, &notification_value, portMAX_DELAY)) == pdTRUE) {
-        memcpy((void *) &ewma_temperature, (const void *) &notification_value, sizeof(float));
-        timestamp = psq4_system_time();
-        sprintf(json, TELEMETRY_JSON_TEMPLATE, timestamp, ewma_temperature);
-        ESP_LOGI(PSQ4_TELEMETRY_TAG, "Emitting a temperature change event: now %0.4f C", ewma_temperature);
-        // Note: this blocks until complete, which with network operations could be a long
-        // time... and that means we could lose datapoints. Fine for getting started, but...
-        // TODO: ensure that significant datapoints are not lost
-        psq4_mqtt_publish(topic, QOS1, json);
-    };
-    ESP_LOGE(
-        PSQ4_TELEMETRY_TAG,
-        "FATAL: failed to receive temperature reading from distributor, code %d",
-        wait_result
-    );
+    static psq4_journal_record_t records[CONFIG_PSQ4_TELEMETRY_BATCH_SIZE];
+    static uint8_t payload[PSQ4_TELEMETRY_PAYLOAD_MAX + 1];
+    size_t payload_len;
+    size_t count;
+    esp_err_t err;
+    while (true) {
+        count = 1;
+        err = psq4_journal_peek(records, &count, portMAX_DELAY);
+        if (err == ESP_OK && CONFIG_PSQ4_TELEMETRY_BATCH_SIZE > 1) {
+            count = CONFIG_PSQ4_TELEMETRY_BATCH_SIZE;
+            err = psq4_journal_peek(
+                records,
+                &count,
+                (CONFIG_PSQ4_TELEMETRY_BATCH_SECONDS * 1000) / portTICK_PERIOD_MS
+            );
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(PSQ4_TELEMETRY_TAG, "Failed to read the telemetry journal: %s", esp_err_to_name(err));
+            vTaskDelay(1000 / portTICK_PERIOD_MS);
+            continue;
+        }
+        PSQ4_TRACE_BEGIN("render_batch");
+        payload_len = psq4_telemetry_render(payload, records, count);
+        PSQ4_TRACE_END("render_batch");
+        ESP_LOGI(
+            PSQ4_TELEMETRY_TAG,
+            "Emitting %d temperature change events in %d bytes",
+            count,
+            payload_len
+        );
+        // Unacknowledged records are simply forwarded again
+        PSQ4_TRACE_BEGIN("publish");
+        IoT_Error_t rc = psq4_mqtt_publish(topic, QOS1, payload, payload_len);
+        PSQ4_TRACE_END("publish");
+        if (rc == SUCCESS) {
+            psq4_journal_ack(records, count);
+            for (size_t i = 0; i < count; i++) {
+                PSQ4_TRACE_ASYNC_END("sample", records[i].seq);
+            }
+        }
+    }
 }
 
 
 void psq4_telemetry_init()
 {
-    xTaskCreate(
+    psq4_journal_init();
+    PSQ4_TASK_CREATE(
+        &temperature_journal_task,
+        "temperatureJournalTask",
+        3072,
+        NULL,
+        5,
+        NULL
+    );
+    PSQ4_TASK_CREATE(
         &temperature_telemetry_task,
         "temperatureTelemetryTask",
-        9056,
+        TELEMETRY_TASK_STACK_SIZE,
         NULL,
         5,
-        &psq4_temperature_telemetry_task
+        NULL
     );
-    ESP_ERROR_CHECK(psq4_temperature_add_consumer(psq4_temperature_telemetry_task, 10000 / portTICK_PERIOD_MS));
 }
@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "psq4_telemetry_format.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <sdkconfig.h>
+#include "psq4_cbor.h"
+#include "psq4_delta.h"
+
+
+#define TELEMETRY_JSON_TEMPLATE "{\"timestamp\": %ld, \"sensor\": %d, \"temperature\": %.4f}"
+
+
+#if CONFIG_PSQ4_TELEMETRY_FORMAT_CBOR || CONFIG_PSQ4_TELEMETRY_FORMAT_DELTA
+
+// Rounds to the nearest hundredth of a degree
+static int32_t centi_degrees(float degrees)
+{
+    float centi = degrees * 100;
+    return (int32_t) (centi + (centi < 0 ? -0.5f : 0.5f));
+}
+
+#endif
+
+
+#if CONFIG_PSQ4_TELEMETRY_FORMAT_CBOR
+
+// Encodes a batch of journaled samples as a CBOR array, returning its length
+size_t psq4_telemetry_render(uint8_t *payload, const psq4_journal_record_t *records, size_t count)
+{
+    psq4_cbor_writer_t writer;
+    psq4_cbor_init(&writer, payload, PSQ4_TELEMETRY_PAYLOAD_MAX);
+    psq4_cbor_put_array(&writer, count);
+    for (size_t i = 0; i < count; i++) {
+        psq4_cbor_put_array(&writer, 3);
+        psq4_cbor_put_uint(&writer, records[i].timestamp);
+        psq4_cbor_put_uint(&writer, records[i].sensor_id);
+        psq4_cbor_put_int(&writer, centi_degrees(records[i].value));
+    }
+    // Can't happen while PSQ4_TELEMETRY_CBOR_SAMPLE_MAX is right
+    assert(!writer.overflow);
+    return writer.len;
+}
+
+#elif CONFIG_PSQ4_TELEMETRY_FORMAT_DELTA
+
+// Compresses a batch of journaled samples, returning its length
+size_t psq4_telemetry_render(uint8_t *payload, const psq4_journal_record_t *records, size_t count)
+{
+    psq4_delta_encoder_t encoder;
+    psq4_delta_init(&encoder, payload, PSQ4_TELEMETRY_PAYLOAD_MAX, count);
+    for (size_t i = 0; i < count; i++) {
+        psq4_delta_put(
+            &encoder,
+            records[i].timestamp,
+            records[i].sensor_id,
+            centi_degrees(records[i].value)
+        );
+    }
+    // Can't happen while PSQ4_TELEMETRY_DELTA_SAMPLE_MAX is right
+    assert(!encoder.overflow);
+    return encoder.len;
+}
+
+#else
+
+// Formats a batch of journaled samples as a JSON array, returning its length
+size_t psq4_telemetry_render(uint8_t *payload, const psq4_journal_record_t *records, size_t count)
+{
+    char *json = (char *) payload;
+    size_t len = 0;
+    int written;
+    json[len++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json[len++] = ',';
+        written = snprintf(
+            json + len,
+            PSQ4_TELEMETRY_JSON_SAMPLE_MAX,
+            TELEMETRY_JSON_TEMPLATE,
+            (long) records[i].timestamp,
+            records[i].sensor_id,
+            records[i].value
+        );
+        len += written < PSQ4_TELEMETRY_JSON_SAMPLE_MAX ? written : PSQ4_TELEMETRY_JSON_SAMPLE_MAX - 1;
+    }
+    json[len++] = ']';
+    json[len] = '\0';
+    return len;
+}
+
+#endif
@@ -27,24 +27,25 @@
 
 static const psq4_gfx_dim_t dim = { 9, 17 };
 
-static const uint8_t data[306] = {
-    0x4A, 0x49, 0x18, 0xE3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0xE3, 0x4A, 0x49,
-    0x18, 0xE3, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x18, 0xE3,
-    0x00, 0x00, 0xFF, 0xFF, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x40, 0xC0, 0x40, 0xC0, 0x40, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x40, 0xC0, 0x40, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x40, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
-    0x18, 0xE3, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x18, 0xE3,
-    0x94, 0x92, 0x00, 0x00, 0x18, 0xE3, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x18, 0xE3, 0x00, 0x00, 0x94, 0x92,
-    0xFF, 0xFF, 0xFF, 0xFF, 0x94, 0x92, 0x18, 0xE3, 0x00, 0x00, 0x18, 0xE3, 0x94, 0x92, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[159] = {
+    0x81, 0x4A, 0x49, 0x18, 0xE3, 0x44, 0x00, 0x00, 0x81, 0x18, 0xE3, 0x4A, 0x49,
+    0x80, 0x18, 0xE3, 0x06, 0x80, 0x18, 0xE3,
+    0x80, 0x00, 0x00, 0x00, 0x44, 0xC0, 0x40, 0x00, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x01, 0x43, 0xC0, 0x40, 0x00, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x02, 0x42, 0xC0, 0x40, 0x00, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x03, 0x41, 0xC0, 0x40, 0x00, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x04, 0x80, 0xC0, 0x40, 0x00, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00,
+    0x80, 0x18, 0xE3, 0x06, 0x80, 0x18, 0xE3,
+    0x82, 0x94, 0x92, 0x00, 0x00, 0x18, 0xE3, 0x02, 0x82, 0x18, 0xE3, 0x00, 0x00, 0x94, 0x92,
+    0x01, 0x84, 0x94, 0x92, 0x18, 0xE3, 0x00, 0x00, 0x18, 0xE3, 0x94, 0x92, 0x01
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_battery_dead_on = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_battery_dead_on = { data, dim };
@@ -35,19 +35,19 @@ extern "C" {
 
 
 // WiFi icons, 21x16px
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_connecting_1;
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_connecting_2;
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_connecting_3;
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_ok;
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_fail;
-
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_connecting;
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_fail;
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_ok;
-
-const psq4_gfx_sprite_t psq4_ui_sprite_battery_dead_on;
-const psq4_gfx_sprite_t psq4_ui_sprite_battery_dead_off;
-const psq4_gfx_sprite_t psq4_ui_sprite_battery_ok;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_connecting_1;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_connecting_2;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_connecting_3;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_ok;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_fail;
+
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_connecting;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_fail;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_ok;
+
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_battery_dead_on;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_battery_dead_off;
+extern const psq4_gfx_rle_sprite_t psq4_ui_sprite_battery_ok;
 
 
 #ifdef __cplusplus
@@ -27,23 +27,24 @@
 
 static const psq4_gfx_dim_t dim = { 21, 16 };
 
-static const uint8_t data[672] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xEF, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x1C, 0xF7, 0x9E, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xEF, 0x7D, 0xF7, 0x9E, 0xEF, 0x7D, 0xE7, 0x1C, 0xEF, 0x7D, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x3C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xE7, 0x1C, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xE7, 0x1C, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x1C, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xEF, 0x5D, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x7D, 0xE7, 0x1C, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xEF, 0x5D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x3C, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xF7, 0x9E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xE7, 0x3C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x5D, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x1C, 0xEF, 0x5D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x7D, 0xE7, 0x1C, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xE7, 0x1C, 0xE7, 0x1C, 0xF7, 0x9E, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0x9E, 0xE7, 0x1C, 0xE7, 0x1C, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x3C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xE7, 0x1C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[161] = {
+    0x14,
+    0x02, 0x4E, 0xE7, 0x1C, 0x80, 0xEF, 0x7D, 0x01,
+    0x01, 0x41, 0xE7, 0x1C, 0x80, 0xF7, 0x9E, 0x4A, 0xEF, 0x7D, 0x83, 0xF7, 0x9E, 0xEF, 0x7D, 0xE7, 0x1C, 0xEF, 0x7D, 0x00,
+    0x00, 0x81, 0xE7, 0x1C, 0xE7, 0x3C, 0x0E, 0x81, 0xFF, 0xDF, 0xE7, 0x1C, 0x00,
+    0x00, 0x80, 0xE7, 0x1C, 0x10, 0x80, 0xE7, 0x1C, 0x00,
+    0x00, 0x81, 0xE7, 0x1C, 0xF7, 0xBE, 0x0E, 0x41, 0xE7, 0x1C, 0x00,
+    0x00, 0x81, 0xEF, 0x5D, 0xE7, 0x1C, 0x0C, 0x80, 0xEF, 0x7D, 0x41, 0xE7, 0x1C, 0x01,
+    0x01, 0x42, 0xE7, 0x1C, 0x80, 0xEF, 0x5D, 0x09, 0x41, 0xE7, 0x1C, 0x02,
+    0x03, 0x81, 0xE7, 0x3C, 0xE7, 0x1C, 0x09, 0x81, 0xE7, 0x1C, 0xF7, 0x9E, 0x02,
+    0x04, 0x81, 0xE7, 0x1C, 0xE7, 0x3C, 0x07, 0x81, 0xEF, 0x5D, 0xE7, 0x1C, 0x03,
+    0x05, 0x81, 0xE7, 0x1C, 0xEF, 0x5D, 0x05, 0x82, 0xEF, 0x7D, 0xE7, 0x1C, 0xFF, 0xDF, 0x03,
+    0x05, 0x80, 0xFF, 0xDF, 0x41, 0xE7, 0x1C, 0x80, 0xF7, 0x9E, 0x01, 0x80, 0xF7, 0x9E, 0x41, 0xE7, 0x1C, 0x80, 0xF7, 0xBE, 0x04,
+    0x07, 0x80, 0xE7, 0x3C, 0x44, 0xE7, 0x1C, 0x06,
+    0x14,
+    0x14,
+    0x14
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_connecting = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_connecting = { data, dim };
@@ -27,23 +27,24 @@
 
 static const psq4_gfx_dim_t dim = { 21, 16 };
 
-static const uint8_t data[672] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x9C, 0xD3, 0x29, 0x45, 0x8C, 0x71, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xF7, 0x9E, 0x29, 0x65, 0x00, 0x00, 0x21, 0x24, 0xE7, 0x3C, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xFD, 0xF7, 0xFE, 0xBA, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFD, 0xF7, 0xFE, 0xFB, 0xFE, 0xBA, 0xFE, 0x9A, 0xFE, 0x9A, 0xFF, 0xDF, 0x8C, 0x71, 0x21, 0x04, 0x84, 0x10, 0xF7, 0xBE, 0xFE, 0x9A, 0xFE, 0x9A, 0xFE, 0x9A, 0xFE, 0xDB, 0xFE, 0x99, 0xFD, 0xF7, 0xFE, 0x99, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFD, 0xF7, 0xFE, 0x17, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xE7, 0x3C, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x9E, 0xFD, 0xF7, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x20, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFD, 0xF7, 0xFF, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0x9E, 0x00, 0x00, 0xF7, 0x9E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFD, 0xF7, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFE, 0x58, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBD, 0xD7, 0x00, 0x00, 0xBD, 0xD7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xFD, 0xF7, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x17, 0xFD, 0xF7, 0xFD, 0xF7, 0xFE, 0x59, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x8C, 0x51, 0x00, 0x20, 0x8C, 0x51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x18, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x5A, 0xEB, 0x00, 0x00, 0x5A, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFE, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFE, 0x17, 0xFF, 0xFF, 0xFF, 0xFF, 0x39, 0xE7, 0x00, 0x00, 0x39, 0xE7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x59, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xF7, 0xFE, 0x58, 0xFF, 0xFF, 0x21, 0x24, 0x00, 0x00, 0x21, 0x24, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xFD, 0xF7, 0xFF, 0x9E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBE, 0xFD, 0xF7, 0xFF, 0xFF, 0x10, 0xA2, 0x00, 0x00, 0x10, 0xA2, 0xFF, 0xFF, 0xFD, 0xF7, 0xFD, 0xF7, 0xFF, 0x5D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFD, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x31, 0xA6, 0x18, 0xC3, 0x31, 0xA6, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x84, 0x10, 0x5A, 0xCB, 0x84, 0x10, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[286] = {
+    0x09, 0x80, 0xF7, 0xBE, 0x09,
+    0x08, 0x83, 0x9C, 0xD3, 0x29, 0x45, 0x8C, 0x71, 0xFF, 0xDF, 0x07,
+    0x02, 0x44, 0xFD, 0xF7, 0x84, 0xF7, 0x9E, 0x29, 0x65, 0x00, 0x00, 0x21, 0x24, 0xE7, 0x3C, 0x44, 0xFD, 0xF7, 0x80, 0xFE, 0xBA, 0x01,
+    0x01, 0x41, 0xFD, 0xF7, 0x81, 0xFE, 0xFB, 0xFE, 0xBA, 0x41, 0xFE, 0x9A, 0x84, 0xFF, 0xDF, 0x8C, 0x71, 0x21, 0x04, 0x84, 0x10, 0xF7, 0xBE, 0x42, 0xFE, 0x9A, 0x83, 0xFE, 0xDB, 0xFE, 0x99, 0xFD, 0xF7, 0xFE, 0x99, 0x00,
+    0x00, 0x81, 0xFD, 0xF7, 0xFE, 0x17, 0x05, 0x82, 0xFF, 0xDF, 0xE7, 0x3C, 0xF7, 0xBE, 0x05, 0x81, 0xFF, 0x9E, 0xFD, 0xF7, 0x00,
+    0x00, 0x80, 0xFD, 0xF7, 0x07, 0x80, 0x00, 0x20, 0x07, 0x80, 0xFD, 0xF7, 0x00,
+    0x00, 0x81, 0xFD, 0xF7, 0xFF, 0x7D, 0x05, 0x82, 0xF7, 0x9E, 0x00, 0x00, 0xF7, 0x9E, 0x05, 0x41, 0xFD, 0xF7, 0x00,
+    0x00, 0x81, 0xFE, 0x58, 0xFD, 0xF7, 0x05, 0x82, 0xBD, 0xD7, 0x00, 0x00, 0xBD, 0xD7, 0x03, 0x80, 0xFE, 0xBA, 0x41, 0xFD, 0xF7, 0x01,
+    0x01, 0x80, 0xFE, 0x17, 0x41, 0xFD, 0xF7, 0x80, 0xFE, 0x59, 0x02, 0x82, 0x8C, 0x51, 0x00, 0x20, 0x8C, 0x51, 0x03, 0x41, 0xFD, 0xF7, 0x02,
+    0x03, 0x81, 0xFE, 0x18, 0xFD, 0xF7, 0x02, 0x82, 0x5A, 0xEB, 0x00, 0x00, 0x5A, 0xEB, 0x03, 0x81, 0xFD, 0xF7, 0xFE, 0xFB, 0x02,
+    0x04, 0x81, 0xFD, 0xF7, 0xFE, 0x17, 0x01, 0x82, 0x39, 0xE7, 0x00, 0x00, 0x39, 0xE7, 0x02, 0x81, 0xFE, 0x59, 0xFD, 0xF7, 0x03,
+    0x05, 0x81, 0xFD, 0xF7, 0xFE, 0x58, 0x00, 0x82, 0x21, 0x24, 0x00, 0x00, 0x21, 0x24, 0x01, 0x82, 0xFE, 0xBA, 0xFD, 0xF7, 0xFF, 0x9E, 0x03,
+    0x05, 0x81, 0xFF, 0xBE, 0xFD, 0xF7, 0x00, 0x82, 0x10, 0xA2, 0x00, 0x00, 0x10, 0xA2, 0x00, 0x41, 0xFD, 0xF7, 0x80, 0xFF, 0x5D, 0x04,
+    0x08, 0x42, 0x00, 0x00, 0x00, 0x80, 0xFD, 0xF7, 0x06,
+    0x08, 0x82, 0x31, 0xA6, 0x18, 0xC3, 0x31, 0xA6, 0x08,
+    0x08, 0x82, 0x84, 0x10, 0x5A, 0xCB, 0x84, 0x10, 0x08
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_fail = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_fail = { data, dim };
@@ -27,23 +27,24 @@
 
 static const psq4_gfx_dim_t dim = { 21, 16 };
 
-static const uint8_t data[672] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x85, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x3C, 0x85, 0x9D, 0xF3, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x7D, 0x4E, 0x75, 0x4E, 0x95, 0xB1, 0x75, 0x2D, 0x44, 0x85, 0x75, 0x2C, 0xFF, 0xFF,
-    0xFF, 0xFF, 0x44, 0x85, 0x4C, 0xA6, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD7, 0x1A, 0x44, 0x85, 0xFF, 0xFF,
-    0xFF, 0xFF, 0x44, 0x85, 0xFF, 0xDE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3C, 0x85, 0xFF, 0xFF,
-    0xFF, 0xFF, 0x3C, 0x85, 0xC6, 0xB8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x3C, 0x85, 0xFF, 0xFF,
-    0xFF, 0xFF, 0x5C, 0xCA, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x8D, 0x90, 0x44, 0x85, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0xA6, 0x3C, 0x85, 0x44, 0x85, 0x64, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x54, 0xA7, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x95, 0xB1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x4C, 0x86, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x64, 0xEB, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x44, 0x85, 0x5C, 0xEA, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x85, 0x6F, 0x44, 0x85, 0xD7, 0x1A, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x5C, 0x44, 0x85, 0x44, 0x85, 0x8D, 0x90, 0xE7, 0x7C, 0xEF, 0x9D, 0xA5, 0xF3, 0x44, 0x85, 0x44, 0x85, 0xBE, 0x76, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4C, 0xA7, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0x44, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[173] = {
+    0x14,
+    0x14,
+    0x02, 0x4E, 0x44, 0x85, 0x80, 0x85, 0x6F, 0x01,
+    0x01, 0x82, 0x44, 0x85, 0x3C, 0x85, 0x9D, 0xF3, 0x49, 0x7D, 0x4E, 0x84, 0x75, 0x4E, 0x95, 0xB1, 0x75, 0x2D, 0x44, 0x85, 0x75, 0x2C, 0x00,
+    0x00, 0x81, 0x44, 0x85, 0x4C, 0xA6, 0x0E, 0x81, 0xD7, 0x1A, 0x44, 0x85, 0x00,
+    0x00, 0x81, 0x44, 0x85, 0xFF, 0xDE, 0x0F, 0x80, 0x3C, 0x85, 0x00,
+    0x00, 0x81, 0x3C, 0x85, 0xC6, 0xB8, 0x0E, 0x81, 0x44, 0x85, 0x3C, 0x85, 0x00,
+    0x00, 0x81, 0x5C, 0xCA, 0x44, 0x85, 0x0C, 0x80, 0x8D, 0x90, 0x41, 0x44, 0x85, 0x01,
+    0x01, 0x83, 0x44, 0xA6, 0x3C, 0x85, 0x44, 0x85, 0x64, 0xEB, 0x09, 0x41, 0x44, 0x85, 0x02,
+    0x03, 0x81, 0x54, 0xA7, 0x44, 0x85, 0x09, 0x81, 0x44, 0x85, 0x95, 0xB1, 0x02,
+    0x04, 0x81, 0x44, 0x85, 0x4C, 0x86, 0x07, 0x81, 0x64, 0xEB, 0x44, 0x85, 0x03,
+    0x05, 0x81, 0x44, 0x85, 0x5C, 0xEA, 0x05, 0x82, 0x85, 0x6F, 0x44, 0x85, 0xD7, 0x1A, 0x03,
+    0x05, 0x80, 0xE7, 0x5C, 0x41, 0x44, 0x85, 0x83, 0x8D, 0x90, 0xE7, 0x7C, 0xEF, 0x9D, 0xA5, 0xF3, 0x41, 0x44, 0x85, 0x80, 0xBE, 0x76, 0x04,
+    0x07, 0x80, 0x4C, 0xA7, 0x44, 0x44, 0x85, 0x06,
+    0x14,
+    0x14
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_mqtt_ok = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_mqtt_ok = { data, dim };
@@ -25,7 +25,9 @@
 #include "psq4_ui.h"
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <freertos/queue.h>
 #include <esp_err.h>
+#include <esp_heap_caps.h>
 #include <esp_log.h>
 #include <sdkconfig.h>
 #include <tft.h>
@@ -35,6 +37,8 @@
 #include "psq4_ui_sprites.h"
 #include <psq4_constants.h>
 #include <psq4_system.h>
+#include <psq4_rtos.h>
+#include <psq4_trace.h>
 
 
 // TODO: consider pinning tasks to different CPUs
@@ -43,15 +47,27 @@
 
 #define PSQ4_UI_COLOR_BG PSQ4_UI_COLOR_WHITE
 
+// Chunks in the flush pipeline: one is filled from the canvas
+// while the other is on its way to the display
+#define PSQ4_UI_FLUSH_CHUNK_COUNT 2
+
+
+// A block of canvas data staged for transfer to the display
+typedef struct {
+    uint16_t *buffer;
+    psq4_gfx_bounds_t bounds;
+    size_t len_bytes;
+} psq4_ui_flush_chunk_t;
+
 
 static const char * PSQ4_UI_TAG = "psq4-ui";
 
 static psq4_gfx_coords_t wifi_sprite_coords;
-static const psq4_gfx_sprite_t * wifi_sprite;
+static const psq4_gfx_rle_sprite_t * wifi_sprite;
 static psq4_gfx_bounds_t wifi_sprite_bounds;
 
 static psq4_gfx_coords_t mqtt_sprite_coords;
-static const psq4_gfx_sprite_t * mqtt_sprite;
+static const psq4_gfx_rle_sprite_t * mqtt_sprite;
 static psq4_gfx_bounds_t mqtt_sprite_bounds;
 
 // static const psq4_gfx_coords_t clock_sprite_coords = { 52, 110 };
@@ -59,7 +75,7 @@ static psq4_gfx_bounds_t mqtt_sprite_bounds;
 // static psq4_gfx_bounds_t clock_sprite_bounds;
 
 static psq4_gfx_coords_t rtc_battery_sprite_coords;
-static const psq4_gfx_sprite_t * rtc_battery_sprite;
+static const psq4_gfx_rle_sprite_t * rtc_battery_sprite;
 static psq4_gfx_bounds_t rtc_battery_sprite_bounds;
 
 static psq4_gfx_dim_t canvas_dim;
@@ -67,10 +83,36 @@ static psq4_gfx_canvas_t canvas;
 static tft_handle_t tft;
 static SemaphoreHandle_t mutex;
 
+static psq4_ui_flush_chunk_t flush_chunks[PSQ4_UI_FLUSH_CHUNK_COUNT];
+// Chunks available to be filled from the canvas
+static QueueHandle_t flush_free_queue;
+// Chunks filled and waiting to be rendered
+static QueueHandle_t flush_ready_queue;
+
+
+// Swaps the sprite shown at coords. Sprites are transparent, so the old
+// one is erased through its own mask rather than by blanking its bounds;
+// both steps land in the same dirty region and are flushed together.
+static void psq4_ui_show_sprite(
+    const psq4_gfx_rle_sprite_t ** shown,
+    const psq4_gfx_rle_sprite_t * sprite,
+    psq4_gfx_coords_t * coords,
+    psq4_gfx_bounds_t * bounds)
+{
+    if (*shown == sprite) return;
+    if (*shown) {
+        psq4_gfx_erase_rle_sprite(&canvas, *shown, PSQ4_UI_COLOR_BG, coords, bounds);
+    }
+    if (sprite) {
+        psq4_gfx_render_rle_sprite(&canvas, sprite, coords, bounds);
+    }
+    *shown = sprite;
+}
+
 
 static bool psq4_ui_wifi_status_indicator(EventBits_t event_bits, uint8_t phase)
 {
-    const psq4_gfx_sprite_t * sprite = NULL;
+    const psq4_gfx_rle_sprite_t * sprite = NULL;
     bool ok = false;
     wifi_sprite_coords.x = canvas_dim.w - 23;
     wifi_sprite_coords.y = canvas_dim.h - 17;
@@ -87,29 +129,19 @@ static bool psq4_ui_wifi_status_indicator(EventBits_t event_bits, uint8_t phase)
         sprite = &psq4_ui_sprite_wifi_ok;
         ok = true;
     } else {
-        if (phase == 2 || phase == 5) {
-            psq4_gfx_fill_rect(&canvas, PSQ4_UI_COLOR_BG, &wifi_sprite_bounds);
-        } else {
+        if (phase != 2 && phase != 5) {
             sprite = &psq4_ui_sprite_wifi_fail;
         }
     }
 
-    if (sprite && wifi_sprite != sprite) {
-        psq4_gfx_render_sprite(
-            &canvas,
-            sprite,
-            &wifi_sprite_coords,
-            &wifi_sprite_bounds
-        );
-        wifi_sprite = sprite;
-    }
+    psq4_ui_show_sprite(&wifi_sprite, sprite, &wifi_sprite_coords, &wifi_sprite_bounds);
 
     return ok;
 }
 
 static bool psq4_ui_mqtt_status_indicator(EventBits_t event_bits, uint8_t phase)
 {
-    const psq4_gfx_sprite_t * sprite = NULL;
+    const psq4_gfx_rle_sprite_t * sprite = NULL;
     bool ok = false;
     mqtt_sprite_coords.x = canvas_dim.w - 49;
     mqtt_sprite_coords.y = canvas_dim.h - 17;
@@ -120,22 +152,12 @@ static bool psq4_ui_mqtt_status_indicator(EventBits_t event_bits, uint8_t phase)
         sprite = &psq4_ui_sprite_mqtt_ok;
         ok = true;
     } else {
-        if (phase == 2 || phase == 5) {
-            psq4_gfx_fill_rect(&canvas, PSQ4_UI_COLOR_BG, &mqtt_sprite_bounds);
-        } else {
+        if (phase != 2 && phase != 5) {
             sprite = &psq4_ui_sprite_mqtt_fail;
         }
     }
 
-    if (sprite && wifi_sprite != sprite) {
-        psq4_gfx_render_sprite(
-            &canvas,
-            sprite,
-            &mqtt_sprite_coords,
-            &mqtt_sprite_bounds
-        );
-        mqtt_sprite = sprite;
-    }
+    psq4_ui_show_sprite(&mqtt_sprite, sprite, &mqtt_sprite_coords, &mqtt_sprite_bounds);
 
     return ok;
 }
@@ -149,7 +171,7 @@ static bool psq4_ui_rtc_status_indicator(EventBits_t event_bits, uint8_t phase)
 
 static bool psq4_ui_rtc_battery_status_indicator(EventBits_t event_bits, uint8_t phase)
 {
-    const psq4_gfx_sprite_t * sprite = NULL;
+    const psq4_gfx_rle_sprite_t * sprite = NULL;
     bool ok = false;
     rtc_battery_sprite_coords.x = canvas_dim.w - 101;
     rtc_battery_sprite_coords.y = canvas_dim.h - 17;
@@ -165,76 +187,101 @@ static bool psq4_ui_rtc_battery_status_indicator(EventBits_t event_bits, uint8_t
         ok = true;
     }
 
-    if (rtc_battery_sprite != sprite) {
-        psq4_gfx_render_sprite(
-            &canvas,
-            sprite,
-            &rtc_battery_sprite_coords,
-            &rtc_battery_sprite_bounds
-        );
-        rtc_battery_sprite = sprite;
-    }
+    psq4_ui_show_sprite(&rtc_battery_sprite, sprite, &rtc_battery_sprite_coords, &rtc_battery_sprite_bounds);
 
     return ok;
 }
 
 
+// Renders filled chunks to the display, returning each to the
+// flush task for reuse once its transfer completes
+static void psq4_ui_render_task(void * ignored)
+{
+    psq4_ui_flush_chunk_t * chunk;
+    while (true) {
+        if (xQueueReceive(flush_ready_queue, &chunk, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        ESP_LOGD(
+            PSQ4_UI_TAG,
+            "Flushing {%d, %d} to {%d, %d}",
+            chunk->bounds.x0,
+            chunk->bounds.y0,
+            chunk->bounds.x1,
+            chunk->bounds.y1
+        );
+        PSQ4_TRACE_BEGIN("tft16_render");
+        tft16_render(
+            tft,
+            chunk->buffer,
+            chunk->bounds.x0,
+            chunk->bounds.y0,
+            chunk->bounds.x1,
+            chunk->bounds.y1
+        );
+        PSQ4_TRACE_END("tft16_render");
+        xQueueSend(flush_free_queue, &chunk, portMAX_DELAY);
+    }
+}
+
+
+// Copies canvas updates into free chunks and hands them to the
+// render task, so that the next chunk is prepared while the
+// previous one is being transferred over SPI
 static void psq4_ui_flush_task(void * pvParameters)
 {
     psq4_ui_params_t * params = (psq4_ui_params_t *) pvParameters;
-    psq4_gfx_bounds_t bounds;
-    size_t len_bytes;
     size_t buffer_len_bytes = params->max_trans_size;
-    uint16_t *buffer = (uint16_t *) malloc(buffer_len_bytes);
-    if (!buffer) {
-        ESP_LOGE(
-            PSQ4_UI_TAG,
-            "Failed to allocate a %d-byte buffer",
-            buffer_len_bytes
-        );
+    psq4_ui_flush_chunk_t * chunk;
+
+    flush_free_queue = PSQ4_QUEUE_CREATE(PSQ4_UI_FLUSH_CHUNK_COUNT, sizeof(psq4_ui_flush_chunk_t *));
+    flush_ready_queue = PSQ4_QUEUE_CREATE(PSQ4_UI_FLUSH_CHUNK_COUNT, sizeof(psq4_ui_flush_chunk_t *));
+    if (!flush_free_queue || !flush_ready_queue) {
+        ESP_LOGE(PSQ4_UI_TAG, "Failed to create flush queues");
         // Returning from the task prompts a restart
         return;
     }
+    for (size_t i = 0; i < PSQ4_UI_FLUSH_CHUNK_COUNT; i++) {
+        chunk = &flush_chunks[i];
+        chunk->buffer = (uint16_t *) heap_caps_malloc(buffer_len_bytes, MALLOC_CAP_DMA);
+        if (!chunk->buffer) {
+            ESP_LOGE(
+                PSQ4_UI_TAG,
+                "Failed to allocate a %d-byte DMA-capable buffer",
+                buffer_len_bytes
+            );
+            // Returning from the task prompts a restart
+            return;
+        }
+        xQueueSend(flush_free_queue, &chunk, portMAX_DELAY);
+    }
 
-    const char * task_name = pcTaskGetTaskName(NULL);
-    size_t stack_rem = uxTaskGetStackHighWaterMark(NULL);
-    ESP_LOGI(PSQ4_UI_TAG, "Stack remaining for task '%s' is %d bytes prior to loop entry", pcTaskGetTaskName(NULL), uxTaskGetStackHighWaterMark(NULL));
+    PSQ4_TASK_CREATE(&psq4_ui_render_task, "renderUITask", 2048, NULL, 5, NULL);
 
     while (true) {
+        // Wait for a chunk to fill
+        if (xQueueReceive(flush_free_queue, &chunk, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
         // Wait for update batches
         if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
             xSemaphoreGive(mutex);
         }
+        chunk->len_bytes = 0;
+        PSQ4_TRACE_BEGIN("gfx_flush");
         esp_err_t ret = psq4_gfx_flush(
             &canvas,
-            buffer,
+            chunk->buffer,
             buffer_len_bytes,
-            &bounds,
-            &len_bytes
+            &chunk->bounds,
+            &chunk->len_bytes
         );
+        PSQ4_TRACE_END("gfx_flush");
         ESP_ERROR_CHECK(ret);
-        ESP_LOGD(
-            PSQ4_UI_TAG,
-            "Flushing {%d, %d} to {%d, %d}",
-            bounds.x0,
-            bounds.y0,
-            bounds.x1,
-            bounds.y1
-        );
-        if (len_bytes > 0) {
-            tft16_render(
-                tft,
-                buffer,
-                bounds.x0,
-                bounds.y0,
-                bounds.x1,
-                bounds.y1
-            );
-        }
-        len_bytes = 0;
-        if (uxTaskGetStackHighWaterMark(NULL) != stack_rem) {
-            stack_rem = uxTaskGetStackHighWaterMark(NULL);
-            ESP_LOGI(PSQ4_UI_TAG, "Stack remaining for task '%s' is %d bytes", task_name, stack_rem);
+        if (chunk->len_bytes > 0) {
+            xQueueSend(flush_ready_queue, &chunk, portMAX_DELAY);
+        } else {
+            xQueueSend(flush_free_queue, &chunk, portMAX_DELAY);
         }
     }
 }
@@ -242,7 +289,7 @@ static void psq4_ui_flush_task(void * pvParameters)
 
 void psq4_ui_task(void * pvParameters)
 {
-    mutex = xSemaphoreCreateMutex();
+    mutex = PSQ4_MUTEX_CREATE();
     st7789_params_t params;
     params.host = CONFIG_PSQ4_SPI_HOST;
     params.gpio_cs = CONFIG_PSQ4_DISPLAY_CS_GPIO;
@@ -259,7 +306,7 @@ void psq4_ui_task(void * pvParameters)
     psq4_gfx_fill_rect(&canvas, PSQ4_UI_COLOR_BG, &canvas_bounds);
 
     // Start flushing to the display
-    xTaskCreate(&psq4_ui_flush_task, "flushUITask", 2048, pvParameters, 5, NULL);
+    PSQ4_TASK_CREATE(&psq4_ui_flush_task, "flushUITask", 2048, pvParameters, 5, NULL);
 
     // Keep the UI up-to-date
     uint8_t phase = 0;
@@ -27,23 +27,24 @@
 
 static const psq4_gfx_dim_t dim = { 21, 16 };
 
-static const uint8_t data[672] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xA5, 0x14, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x8C, 0x71, 0x31, 0x86, 0x8C, 0x71, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7B, 0xCF, 0x31, 0x86, 0x31, 0x86, 0x31, 0x86, 0x7B, 0xCF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xAD, 0x55, 0x4A, 0x69, 0x31, 0x86, 0x4A, 0x69, 0xAD, 0x55, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCE, 0x59, 0xEF, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x7D, 0xCE, 0x59, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC6, 0x18, 0x9C, 0xD3, 0x9C, 0xD3, 0xCE, 0x79, 0xF7, 0x9E, 0xFF, 0xFF, 0xF7, 0x9E, 0xCE, 0x79, 0x9C, 0xD3, 0x9C, 0xD3, 0xC6, 0x18, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xB5, 0xB6, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0xB5, 0xB6, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBD, 0xD7, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0xBD, 0xD7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xDE, 0xFB, 0xFF, 0xDF, 0xFF, 0xFF, 0xEF, 0x7D, 0xAD, 0x55, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0x9C, 0xD3, 0xAD, 0x55, 0xEF, 0x7D, 0xFF, 0xFF, 0xFF, 0xDF, 0xDE, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xDE, 0xFB, 0xCE, 0x79, 0xCE, 0x79, 0xF7, 0x9E, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xD6, 0x9A, 0xBD, 0xF7, 0xB5, 0xB6, 0xBD, 0xF7, 0xD6, 0x9A, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0x9E, 0xCE, 0x79, 0xCE, 0x79, 0xDE, 0xFB, 0xFF, 0xFF,
-    0xD6, 0xBA, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xDE, 0xDB, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xDE, 0xDB, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xD6, 0xBA,
-    0xE7, 0x1C, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xDE, 0xFB, 0xE7, 0x3C, 0xEF, 0x5D, 0xE7, 0x3C, 0xDE, 0xFB, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xE7, 0x1C,
-    0xFF, 0xFF, 0xF7, 0x9E, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xF7, 0x9E, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x3C, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xE7, 0x3C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x5D, 0xDE, 0xDB, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xCE, 0x79, 0xDE, 0xDB, 0xEF, 0x5D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xF7, 0xBE, 0xF7, 0x9E, 0xF7, 0xBE, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[256] = {
+    0x09, 0x80, 0xA5, 0x14, 0x09,
+    0x08, 0x82, 0x8C, 0x71, 0x31, 0x86, 0x8C, 0x71, 0x08,
+    0x07, 0x80, 0x7B, 0xCF, 0x42, 0x31, 0x86, 0x80, 0x7B, 0xCF, 0x07,
+    0x07, 0x84, 0xAD, 0x55, 0x4A, 0x69, 0x31, 0x86, 0x4A, 0x69, 0xAD, 0x55, 0x07,
+    0x05, 0x81, 0xCE, 0x59, 0xEF, 0x7D, 0x04, 0x81, 0xEF, 0x7D, 0xCE, 0x59, 0x05,
+    0x04, 0x80, 0xC6, 0x18, 0x41, 0x9C, 0xD3, 0x81, 0xCE, 0x79, 0xF7, 0x9E, 0x00, 0x81, 0xF7, 0x9E, 0xCE, 0x79, 0x41, 0x9C, 0xD3, 0x80, 0xC6, 0x18, 0x04,
+    0x03, 0x80, 0xB5, 0xB6, 0x4A, 0x9C, 0xD3, 0x80, 0xB5, 0xB6, 0x03,
+    0x03, 0x80, 0xBD, 0xD7, 0x4A, 0x9C, 0xD3, 0x80, 0xBD, 0xD7, 0x03,
+    0x01, 0x81, 0xDE, 0xFB, 0xFF, 0xDF, 0x00, 0x81, 0xEF, 0x7D, 0xAD, 0x55, 0x46, 0x9C, 0xD3, 0x81, 0xAD, 0x55, 0xEF, 0x7D, 0x00, 0x81, 0xFF, 0xDF, 0xDE, 0xFB, 0x01,
+    0x00, 0x80, 0xDE, 0xFB, 0x41, 0xCE, 0x79, 0x80, 0xF7, 0x9E, 0x01, 0x86, 0xF7, 0xBE, 0xD6, 0x9A, 0xBD, 0xF7, 0xB5, 0xB6, 0xBD, 0xF7, 0xD6, 0x9A, 0xF7, 0xBE, 0x01, 0x80, 0xF7, 0x9E, 0x41, 0xCE, 0x79, 0x80, 0xDE, 0xFB, 0x00,
+    0x80, 0xD6, 0xBA, 0x43, 0xCE, 0x79, 0x81, 0xDE, 0xDB, 0xF7, 0xBE, 0x06, 0x81, 0xF7, 0xBE, 0xDE, 0xDB, 0x43, 0xCE, 0x79, 0x80, 0xD6, 0xBA,
+    0x80, 0xE7, 0x1C, 0x46, 0xCE, 0x79, 0x84, 0xDE, 0xFB, 0xE7, 0x3C, 0xEF, 0x5D, 0xE7, 0x3C, 0xDE, 0xFB, 0x46, 0xCE, 0x79, 0x80, 0xE7, 0x1C,
+    0x00, 0x80, 0xF7, 0x9E, 0x50, 0xCE, 0x79, 0x80, 0xF7, 0x9E, 0x00,
+    0x02, 0x80, 0xE7, 0x3C, 0x4C, 0xCE, 0x79, 0x80, 0xE7, 0x3C, 0x02,
+    0x04, 0x81, 0xEF, 0x5D, 0xDE, 0xDB, 0x46, 0xCE, 0x79, 0x81, 0xDE, 0xDB, 0xEF, 0x5D, 0x04,
+    0x07, 0x41, 0xF7, 0xBE, 0x80, 0xF7, 0x9E, 0x41, 0xF7, 0xBE, 0x07
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_connecting_3 = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_connecting_3 = { data, dim };
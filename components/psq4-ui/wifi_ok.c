@@ -27,23 +27,24 @@
 
 static const psq4_gfx_dim_t dim = { 21, 16 };
 
-static const uint8_t data[672] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x85, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x74, 0xAD, 0x43, 0xE5, 0x74, 0xAD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x64, 0x6A, 0x43, 0xE5, 0x43, 0xE5, 0x3B, 0xE5, 0x64, 0x6A, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x8D, 0x30, 0x4C, 0x06, 0x43, 0xE5, 0x4C, 0x07, 0x8D, 0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x8D, 0x90, 0xD6, 0xFA, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD6, 0xFA, 0x8D, 0x90, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x85, 0x6F, 0x5C, 0xC8, 0x5C, 0xC8, 0x95, 0xB1, 0xDF, 0x3B, 0xFF, 0xFF, 0xDF, 0x3B, 0x95, 0xB1, 0x5C, 0xC8, 0x5C, 0xC8, 0x85, 0x4E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x75, 0x2C, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC9, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xC8, 0x75, 0x2C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7D, 0x2D, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xC8, 0x7D, 0x4D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0x95, 0xD0, 0xE7, 0x5C, 0xFF, 0xFF, 0xD7, 0x1A, 0x6C, 0xEA, 0x5C, 0xC8, 0x5C, 0xC8, 0x5C, 0xC9, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xA8, 0x5C, 0xC8, 0x6C, 0xEB, 0xD7, 0x1A, 0xFF, 0xFF, 0xE7, 0x5C, 0x95, 0xD0, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0x95, 0xD0, 0x65, 0x2A, 0x6D, 0x2A, 0xCE, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0x5C, 0x9D, 0xD2, 0x7D, 0x4E, 0x75, 0x2D, 0x7D, 0x4E, 0x9D, 0xD2, 0xE7, 0x7C, 0xFF, 0xFF, 0xFF, 0xFF, 0xCE, 0xF9, 0x65, 0x2A, 0x65, 0x2A, 0x95, 0xD0, 0xFF, 0xFF,
-    0x7D, 0x6D, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x7D, 0x6D, 0xD7, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD7, 0x19, 0x7D, 0x6D, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x7D, 0x6D,
-    0x95, 0xD0, 0x65, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x8D, 0xB0, 0xA6, 0x34, 0xB6, 0x75, 0xA6, 0x34, 0x8D, 0xB0, 0x6D, 0x2B, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x95, 0xD0,
-    0xFF, 0xFF, 0xCE, 0xF9, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0xCE, 0xF9, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xA6, 0x13, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0xA6, 0x13, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xB6, 0x75, 0x85, 0x8E, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x85, 0x8E, 0xB6, 0x75, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xBE, 0xDF, 0x5B, 0xD7, 0x1A, 0xCE, 0xF9, 0xD7, 0x1A, 0xDF, 0x5B, 0xF7, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+// Run-length encoded, one row per line
+static const uint8_t data[356] = {
+    0x09, 0x80, 0x85, 0x0F, 0x09,
+    0x08, 0x82, 0x74, 0xAD, 0x43, 0xE5, 0x74, 0xAD, 0x08,
+    0x07, 0x80, 0x64, 0x6A, 0x41, 0x43, 0xE5, 0x81, 0x3B, 0xE5, 0x64, 0x6A, 0x07,
+    0x07, 0x84, 0x8D, 0x30, 0x4C, 0x06, 0x43, 0xE5, 0x4C, 0x07, 0x8D, 0x30, 0x07,
+    0x05, 0x81, 0x8D, 0x90, 0xD6, 0xFA, 0x04, 0x81, 0xD6, 0xFA, 0x8D, 0x90, 0x05,
+    0x04, 0x80, 0x85, 0x6F, 0x41, 0x5C, 0xC8, 0x81, 0x95, 0xB1, 0xDF, 0x3B, 0x00, 0x81, 0xDF, 0x3B, 0x95, 0xB1, 0x41, 0x5C, 0xC8, 0x80, 0x85, 0x4E, 0x04,
+    0x03, 0x80, 0x75, 0x2C, 0x41, 0x5C, 0xC8, 0x82, 0x5C, 0xA8, 0x5C, 0xC8, 0x5C, 0xA8, 0x41, 0x5C, 0xC8, 0x84, 0x5C, 0xC9, 0x5C, 0xC8, 0x5C, 0xA8, 0x5C, 0xC8, 0x75, 0x2C, 0x03,
+    0x03, 0x80, 0x7D, 0x2D, 0x48, 0x5C, 0xC8, 0x82, 0x5C, 0xA8, 0x5C, 0xC8, 0x7D, 0x4D, 0x03,
+    0x01, 0x81, 0x95, 0xD0, 0xE7, 0x5C, 0x00, 0x81, 0xD7, 0x1A, 0x6C, 0xEA, 0x41, 0x5C, 0xC8, 0x81, 0x5C, 0xC9, 0x5C, 0xC8, 0x41, 0x5C, 0xA8, 0x82, 0x5C, 0xC8, 0x6C, 0xEB, 0xD7, 0x1A, 0x00, 0x81, 0xE7, 0x5C, 0x95, 0xD0, 0x01,
+    0x00, 0x83, 0x95, 0xD0, 0x65, 0x2A, 0x6D, 0x2A, 0xCE, 0xF9, 0x01, 0x86, 0xE7, 0x5C, 0x9D, 0xD2, 0x7D, 0x4E, 0x75, 0x2D, 0x7D, 0x4E, 0x9D, 0xD2, 0xE7, 0x7C, 0x01, 0x80, 0xCE, 0xF9, 0x41, 0x65, 0x2A, 0x80, 0x95, 0xD0, 0x00,
+    0x80, 0x7D, 0x6D, 0x42, 0x65, 0x2A, 0x82, 0x6D, 0x2A, 0x7D, 0x6D, 0xD7, 0x19, 0x06, 0x81, 0xD7, 0x19, 0x7D, 0x6D, 0x41, 0x65, 0x2A, 0x41, 0x6D, 0x2A, 0x80, 0x7D, 0x6D,
+    0x81, 0x95, 0xD0, 0x65, 0x2A, 0x41, 0x6D, 0x2A, 0x42, 0x65, 0x2A, 0x86, 0x6D, 0x2A, 0x8D, 0xB0, 0xA6, 0x34, 0xB6, 0x75, 0xA6, 0x34, 0x8D, 0xB0, 0x6D, 0x2B, 0x45, 0x65, 0x2A, 0x80, 0x95, 0xD0,
+    0x00, 0x80, 0xCE, 0xF9, 0x44, 0x65, 0x2A, 0x80, 0x6D, 0x2A, 0x41, 0x65, 0x2A, 0x44, 0x6D, 0x2A, 0x42, 0x65, 0x2A, 0x81, 0x6D, 0x2A, 0xCE, 0xF9, 0x00,
+    0x01, 0x81, 0xF7, 0xBE, 0xA6, 0x13, 0x43, 0x65, 0x2A, 0x41, 0x6D, 0x2A, 0x41, 0x65, 0x2A, 0x82, 0x6D, 0x2A, 0x65, 0x2A, 0x6D, 0x2A, 0x41, 0x65, 0x2A, 0x81, 0xA6, 0x13, 0xF7, 0xBE, 0x01,
+    0x03, 0x82, 0xF7, 0xBE, 0xB6, 0x75, 0x85, 0x8E, 0x41, 0x65, 0x2A, 0x80, 0x6D, 0x2A, 0x42, 0x65, 0x2A, 0x83, 0x6D, 0x2A, 0x85, 0x8E, 0xB6, 0x75, 0xF7, 0xBE, 0x03,
+    0x06, 0x86, 0xF7, 0xBE, 0xDF, 0x5B, 0xD7, 0x1A, 0xCE, 0xF9, 0xD7, 0x1A, 0xDF, 0x5B, 0xF7, 0xBE, 0x06
 };
 
-const psq4_gfx_sprite_t psq4_ui_sprite_wifi_ok = { (uint16_t *) data, dim };
+const psq4_gfx_rle_sprite_t psq4_ui_sprite_wifi_ok = { data, dim };
@@ -0,0 +1,44 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_HOST_SDKCONFIG_H
+#define PSQ4_HOST_SDKCONFIG_H
+
+// The Kconfig defaults, for host builds. Options may be overridden
+// with compile definitions; see host/CMakeLists.txt.
+
+#if !CONFIG_PSQ4_TELEMETRY_FORMAT_CBOR && !CONFIG_PSQ4_TELEMETRY_FORMAT_DELTA
+#undef CONFIG_PSQ4_TELEMETRY_FORMAT_JSON
+#define CONFIG_PSQ4_TELEMETRY_FORMAT_JSON 1
+#endif
+
+#ifndef CONFIG_PSQ4_TELEMETRY_BATCH_SIZE
+#define CONFIG_PSQ4_TELEMETRY_BATCH_SIZE 10
+#endif
+
+#ifndef CONFIG_PSQ4_TELEMETRY_BATCH_SECONDS
+#define CONFIG_PSQ4_TELEMETRY_BATCH_SECONDS 60
+#endif
+
+#endif // PSQ4_HOST_SDKCONFIG_H
@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// POSIX implementations of the FreeRTOS and ESP-IDF functions declared
+// by the host shim headers
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_err.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+
+static SemaphoreHandle_t semaphore_init(StaticSemaphore_t *semaphore, UBaseType_t count, int allocated)
+{
+    if (semaphore == NULL) return NULL;
+    semaphore->allocated = allocated;
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->available, NULL);
+    semaphore->count = count;
+    semaphore->max_count = 1;
+    return semaphore;
+}
+
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return semaphore_init(malloc(sizeof(StaticSemaphore_t)), 1, 1);
+}
+
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    return semaphore_init(buffer, 1, 0);
+}
+
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return semaphore_init(malloc(sizeof(StaticSemaphore_t)), 0, 1);
+}
+
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer)
+{
+    return semaphore_init(buffer, 0, 0);
+}
+
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    if (ticks_to_wait != portMAX_DELAY) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += ticks_to_wait / 1000;
+        deadline.tv_nsec += (long) (ticks_to_wait % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+    pthread_mutex_lock(&semaphore->lock);
+    int err = 0;
+    while (semaphore->count == 0 && err != ETIMEDOUT) {
+        if (ticks_to_wait == 0) {
+            err = ETIMEDOUT;
+        } else if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&semaphore->available, &semaphore->lock);
+        } else {
+            err = pthread_cond_timedwait(&semaphore->available, &semaphore->lock, &deadline);
+        }
+    }
+    BaseType_t taken = semaphore->count > 0 ? pdTRUE : pdFALSE;
+    if (taken) semaphore->count--;
+    pthread_mutex_unlock(&semaphore->lock);
+    return taken;
+}
+
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    pthread_mutex_lock(&semaphore->lock);
+    BaseType_t given = semaphore->count < semaphore->max_count ? pdTRUE : pdFALSE;
+    if (given) {
+        semaphore->count++;
+        pthread_cond_signal(&semaphore->available);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return given;
+}
+
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    pthread_cond_destroy(&semaphore->available);
+    pthread_mutex_destroy(&semaphore->lock);
+    if (semaphore->allocated) free(semaphore);
+}
+
+
+TickType_t xTaskGetTickCount(void)
+{
+    static struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) start = now;
+    return (TickType_t) ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+}
+
+
+void vTaskDelay(TickType_t ticks_to_delay)
+{
+    struct timespec delay = {
+        .tv_sec = ticks_to_delay / 1000,
+        .tv_nsec = (long) (ticks_to_delay % 1000) * 1000000,
+    };
+    nanosleep(&delay, NULL);
+}
+
+
+int64_t esp_timer_get_time(void)
+{
+    static struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) start = now;
+    return (int64_t) (now.tv_sec - start.tv_sec) * 1000000 + (now.tv_nsec - start.tv_nsec) / 1000;
+}
+
+
+uint32_t esp_random(void)
+{
+    return ((uint32_t) random() << 16) ^ (uint32_t) random();
+}
+
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "UNKNOWN ERROR";
+    }
+}
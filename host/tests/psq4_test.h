@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PSQ4_TEST_H
+#define PSQ4_TEST_H
+
+// Just enough to write host tests as plain executables for ctest: each
+// check that fails is reported and counted, and PSQ4_TEST_RESULT() is
+// main's return value.
+
+#include <stdio.h>
+
+
+static int psq4_test_failures = 0;
+
+
+#define PSQ4_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            psq4_test_failures++; \
+        } \
+    } while (0)
+
+
+#define PSQ4_CHECK_EQ(expected, actual) \
+    do { \
+        long long psq4_expected = (long long) (expected); \
+        long long psq4_actual = (long long) (actual); \
+        if (psq4_expected != psq4_actual) { \
+            fprintf( \
+                stderr, \
+                "%s:%d: expected %s == %lld, got %lld\n", \
+                __FILE__, \
+                __LINE__, \
+                #actual, \
+                psq4_expected, \
+                psq4_actual \
+            ); \
+            psq4_test_failures++; \
+        } \
+    } while (0)
+
+
+#define PSQ4_TEST_RESULT() (psq4_test_failures == 0 ? 0 : 1)
+
+#endif // PSQ4_TEST_H
@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Round-trips series through psq4_delta and a decoder written from the
+// format's documentation in psq4_delta.h. Given a directory, also writes
+// each series there, with the samples it holds, for
+// tools/psq4_telemetry_decode.py to be checked against (see
+// test_delta_decode.py).
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <psq4_delta.h>
+#include "psq4_test.h"
+
+
+#define TEST_MAX_SAMPLES 512
+#define TEST_BUF_SIZE (2 + 5 + TEST_MAX_SAMPLES * 15)
+
+
+typedef struct {
+    uint32_t timestamp;
+    uint8_t sensor_id;
+    int32_t centi_degrees;
+} test_sample_t;
+
+
+static const char *fixture_dir;
+static uint8_t buf[TEST_BUF_SIZE];
+static test_sample_t decoded[TEST_MAX_SAMPLES];
+
+
+static bool get_varint(const uint8_t *buf, size_t len, size_t *pos, uint32_t *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) return false;
+        uint8_t byte = buf[(*pos)++];
+        *value |= (uint32_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+
+static uint32_t unzigzag(uint32_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+
+// Returns the samples decoded, or -1 if the series is malformed
+static int decode(const uint8_t *buf, size_t len)
+{
+    size_t pos = 1;
+    uint32_t count;
+    uint32_t value;
+    uint32_t timestamp = 0;
+    uint32_t delta = 0;
+    uint32_t seen = 0;
+    uint32_t last_values[PSQ4_TEMPERATURE_MAX_SENSORS];
+    if (len < 1 || buf[0] != PSQ4_DELTA_VERSION) return -1;
+    if (!get_varint(buf, len, &pos, &count) || count > TEST_MAX_SAMPLES) return -1;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t sensor_id;
+        if (!get_varint(buf, len, &pos, &sensor_id) || sensor_id >= PSQ4_TEMPERATURE_MAX_SENSORS) return -1;
+        if (!get_varint(buf, len, &pos, &value)) return -1;
+        if (i == 0) {
+            timestamp = value;
+        } else {
+            delta = i == 1 ? unzigzag(value) : delta + unzigzag(value);
+            timestamp += delta;
+        }
+        if (!get_varint(buf, len, &pos, &value)) return -1;
+        value = unzigzag(value);
+        if (seen & (1 << sensor_id)) value += last_values[sensor_id];
+        seen |= 1 << sensor_id;
+        last_values[sensor_id] = value;
+        decoded[i].timestamp = timestamp;
+        decoded[i].sensor_id = sensor_id;
+        decoded[i].centi_degrees = (int32_t) value;
+    }
+    return pos == len ? (int) count : -1;
+}
+
+
+static void write_fixture(const char *name, const test_sample_t *samples, size_t count, size_t len)
+{
+    if (fixture_dir == NULL) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.bin", fixture_dir, name);
+    FILE *f = fopen(path, "wb");
+    PSQ4_CHECK(f != NULL);
+    if (f == NULL) return;
+    fwrite(buf, 1, len, f);
+    fclose(f);
+    snprintf(path, sizeof(path), "%s/%s.txt", fixture_dir, name);
+    f = fopen(path, "w");
+    PSQ4_CHECK(f != NULL);
+    if (f == NULL) return;
+    for (size_t i = 0; i < count; i++) {
+        fprintf(f, "%u %u %d\n", samples[i].timestamp, samples[i].sensor_id, samples[i].centi_degrees);
+    }
+    fclose(f);
+}
+
+
+// Encodes, decodes and compares, returning the encoded length
+static size_t round_trip(const char *name, const test_sample_t *samples, size_t count)
+{
+    psq4_delta_encoder_t encoder;
+    psq4_delta_init(&encoder, buf, sizeof(buf), count);
+    for (size_t i = 0; i < count; i++) {
+        psq4_delta_put(&encoder, samples[i].timestamp, samples[i].sensor_id, samples[i].centi_degrees);
+    }
+    PSQ4_CHECK(!encoder.overflow);
+    int decoded_count = decode(buf, encoder.len);
+    PSQ4_CHECK_EQ(count, decoded_count);
+    for (int i = 0; i < decoded_count; i++) {
+        if (
+            decoded[i].timestamp != samples[i].timestamp ||
+            decoded[i].sensor_id != samples[i].sensor_id ||
+            decoded[i].centi_degrees != samples[i].centi_degrees
+           )
+        {
+            fprintf(stderr, "%s: sample %d does not round-trip\n", name, i);
+            psq4_test_failures++;
+            break;
+        }
+    }
+    write_fixture(name, samples, count, encoder.len);
+    return encoder.len;
+}
+
+
+// Magnitudes at the edges of each varint length, and of int32
+static void test_zigzag_edges()
+{
+    static const int32_t values[] = {
+        0, -1, 1, -64, 63, -65, 64, -8192, 8191, -8193, 8192,
+        INT32_MAX, INT32_MIN, INT32_MAX, 0, INT32_MIN, -1,
+    };
+    test_sample_t samples[sizeof(values) / sizeof(values[0])];
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        samples[i] = (test_sample_t) { 1600000000 + i, 0, values[i] };
+    }
+    round_trip("zigzag", samples, sizeof(values) / sizeof(values[0]));
+
+    // Deltas of delta at the extremes too
+    static const uint32_t timestamps[] = {
+        0, UINT32_MAX, 0, 0x80000000, 0x7FFFFFFF, 0x80000000, 1, 1, 1,
+    };
+    for (size_t i = 0; i < sizeof(timestamps) / sizeof(timestamps[0]); i++) {
+        samples[i] = (test_sample_t) { timestamps[i], 0, 2000 };
+    }
+    round_trip("timestamp-edges", samples, sizeof(timestamps) / sizeof(timestamps[0]));
+}
+
+
+// Timestamps counting up through the wrap of 32 bits
+static void test_counter_wrap()
+{
+    test_sample_t samples[64];
+    for (size_t i = 0; i < 64; i++) {
+        samples[i] = (test_sample_t) { UINT32_MAX - 31 * 10 + i * 10, 0, 1850 + (int32_t) (i % 3) };
+    }
+    size_t len = round_trip("wrap", samples, 64);
+    // The wrap is just another steady step
+    PSQ4_CHECK(len <= 2 + 5 + 64 * 3 + 6);
+}
+
+
+// Several sensors, interleaved irregularly, each a delta from its own last
+static void test_interleaved_sensors()
+{
+    static test_sample_t samples[TEST_MAX_SAMPLES];
+    int32_t values[PSQ4_TEMPERATURE_MAX_SENSORS];
+    uint32_t seed = 1;
+    uint32_t timestamp = 1600000000;
+    for (size_t s = 0; s < PSQ4_TEMPERATURE_MAX_SENSORS; s++) values[s] = -500 + 700 * (int32_t) s;
+    for (size_t i = 0; i < TEST_MAX_SAMPLES; i++) {
+        seed = seed * 1664525 + 1013904223;
+        uint8_t sensor_id = (seed >> 24) % PSQ4_TEMPERATURE_MAX_SENSORS;
+        values[sensor_id] += (int32_t) ((seed >> 8) % 21) - 10;
+        timestamp += (seed >> 16) % 4 == 0 ? 0 : 1;
+        samples[i] = (test_sample_t) { timestamp, sensor_id, values[sensor_id] };
+    }
+    round_trip("interleaved", samples, TEST_MAX_SAMPLES);
+}
+
+
+// Steady 1 Hz samples from three probes take about three bytes each
+static void test_steady_size()
+{
+    static test_sample_t samples[300];
+    for (size_t i = 0; i < 300; i++) {
+        samples[i] = (test_sample_t) { 1600000000 + (uint32_t) (i / 3), i % 3, 1800 + (int32_t) (i % 7) };
+    }
+    size_t len = round_trip("steady", samples, 300);
+    PSQ4_CHECK(len <= 2 + 2 + 300 * 3 + 8);
+}
+
+
+static void test_overflow()
+{
+    psq4_delta_encoder_t encoder;
+    // Room for the header and the first sample, which takes 8 bytes
+    uint8_t small[11];
+    psq4_delta_init(&encoder, small, sizeof(small), 3);
+    psq4_delta_put(&encoder, 1600000000, 0, 1800);
+    PSQ4_CHECK(!encoder.overflow);
+    psq4_delta_put(&encoder, 1600000001, 0, 1801);
+    PSQ4_CHECK(encoder.overflow);
+    PSQ4_CHECK(encoder.len <= sizeof(small));
+}
+
+
+int main(int argc, char **argv)
+{
+    fixture_dir = argc > 1 ? argv[1] : NULL;
+    test_zigzag_edges();
+    test_counter_wrap();
+    test_interleaved_sensors();
+    test_steady_size();
+    test_overflow();
+    return PSQ4_TEST_RESULT();
+}
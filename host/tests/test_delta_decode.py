@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2020 Michael Volk
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice, this permission notice, and the disclaimer below
+# shall be included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Checks tools/psq4_telemetry_decode.py against series encoded by psq4_delta.
+
+Usage:
+
+    test_delta_decode.py <tools directory> <fixture directory>
+
+test_delta writes each series it encodes to the fixture directory as
+<name>.bin, with the samples it holds in <name>.txt, one "timestamp sensor
+centi-degrees" line per sample.
+"""
+
+import glob
+import os
+import sys
+
+
+def main():
+    # Leave no bytecode behind in the source tree
+    sys.dont_write_bytecode = True
+    sys.path.insert(0, sys.argv[1])
+    from psq4_telemetry_decode import decode
+
+    failures = 0
+    fixtures = sorted(glob.glob(os.path.join(sys.argv[2], '*.bin')))
+    if not fixtures:
+        print('no fixtures in %s' % sys.argv[2], file=sys.stderr)
+        return 1
+    for path in fixtures:
+        with open(path, 'rb') as f:
+            samples = decode(f.read())
+        with open(path[:-len('.bin')] + '.txt') as f:
+            expected = [tuple(int(field) for field in line.split()) for line in f]
+        actual = [
+            (s['timestamp'], s['sensor'], round(s['temperature'] * 100))
+            for s in samples
+        ]
+        if actual != expected:
+            print('%s: decoded samples differ' % path, file=sys.stderr)
+            failures += 1
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
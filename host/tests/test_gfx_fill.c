@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that the row-span fill kernels behind psq4_gfx_fill_rect()
+// paint exactly the pixels a per-pixel loop would, whatever the span's
+// alignment and length
+
+#include <string.h>
+#include <psq4_gfx.h>
+#include "psq4_test.h"
+
+
+#define TEST_CANVAS_W 37
+#define TEST_CANVAS_H 9
+#define TEST_BACKGROUND 0x1234
+#define TEST_COLOR 0xE007
+
+
+static uint16_t expected[TEST_CANVAS_W * TEST_CANVAS_H];
+
+
+static void reset(psq4_gfx_canvas_t *canvas)
+{
+    for (size_t i = 0; i < TEST_CANVAS_W * TEST_CANVAS_H; i++) {
+        canvas->data[i] = TEST_BACKGROUND;
+        expected[i] = TEST_BACKGROUND;
+    }
+}
+
+
+static void check_fill(psq4_gfx_canvas_t *canvas, psq4_gfx_bounds_t bounds)
+{
+    reset(canvas);
+    for (int y = bounds.y0; y <= bounds.y1; y++) {
+        for (int x = bounds.x0; x <= bounds.x1; x++) {
+            expected[y * TEST_CANVAS_W + x] = TEST_COLOR;
+        }
+    }
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_fill_rect(canvas, TEST_COLOR, &bounds));
+    if (memcmp(canvas->data, expected, sizeof(expected)) != 0) {
+        fprintf(
+            stderr,
+            "fill of (%u, %u)-(%u, %u) differs from per-pixel fill\n",
+            bounds.x0,
+            bounds.y0,
+            bounds.x1,
+            bounds.y1
+        );
+        psq4_test_failures++;
+    }
+}
+
+
+int main()
+{
+    psq4_gfx_canvas_t canvas;
+    psq4_gfx_dim_t dim = { TEST_CANVAS_W, TEST_CANVAS_H };
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_init(&canvas, &dim));
+
+    // Rows of an odd-width canvas start alternately word aligned and not,
+    // so this covers both alignments of every start column and length
+    for (int y0 = 0; y0 < 2; y0++) {
+        for (int x0 = 0; x0 < TEST_CANVAS_W; x0++) {
+            for (int x1 = x0; x1 < TEST_CANVAS_W; x1++) {
+                check_fill(&canvas, (psq4_gfx_bounds_t) { x0, y0, x1, y0 + 2 });
+            }
+        }
+    }
+    // Full-width fills take the contiguous fast path
+    for (int y0 = 0; y0 < TEST_CANVAS_H; y0++) {
+        for (int y1 = y0; y1 < TEST_CANVAS_H; y1++) {
+            check_fill(&canvas, (psq4_gfx_bounds_t) { 0, y0, TEST_CANVAS_W - 1, y1 });
+        }
+    }
+
+    psq4_gfx_free(&canvas);
+    return PSQ4_TEST_RESULT();
+}
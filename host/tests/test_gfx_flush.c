@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks how many bytes psq4-gfx flushes per update, which is what
+// dirty region tracking exists to keep down
+
+#include <string.h>
+#include <psq4_gfx.h>
+#include <psq4_ui_sprites.h>
+#include "psq4_test.h"
+
+
+// As the Adafruit 1.14" display driven by psq4-ui
+#define TEST_CANVAS_W 240
+#define TEST_CANVAS_H 135
+#define TEST_FLUSH_BUFFER_BYTES 4096
+#define TEST_BACKGROUND 0x0000
+#define TEST_MERGE_TRIALS 1000
+// More than the canvas tracks, so that regions must be merged
+#define TEST_MERGE_RECTS (PSQ4_GFX_MAX_DIRTY_RECTS * 3)
+
+
+static uint8_t flush_buffer[TEST_FLUSH_BUFFER_BYTES];
+static uint8_t flushed[TEST_CANVAS_H][TEST_CANVAS_W];
+
+
+// Flushes every dirty region, marking the pixels flushed
+static size_t flush_all(psq4_gfx_canvas_t *canvas)
+{
+    psq4_gfx_bounds_t bounds;
+    size_t len_bytes;
+    size_t total = 0;
+    memset(flushed, 0, sizeof(flushed));
+    while (canvas->dirty_rect_count > 0) {
+        len_bytes = 0;
+        PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_flush(canvas, flush_buffer, sizeof(flush_buffer), &bounds, &len_bytes));
+        PSQ4_CHECK_EQ((bounds.x1 - bounds.x0 + 1) * (bounds.y1 - bounds.y0 + 1) * 2, len_bytes);
+        for (int y = bounds.y0; y <= bounds.y1; y++) {
+            memset(&flushed[y][bounds.x0], 1, bounds.x1 - bounds.x0 + 1);
+        }
+        total += len_bytes;
+    }
+    return total;
+}
+
+
+static void test_status_icon(psq4_gfx_canvas_t *canvas)
+{
+    const psq4_gfx_rle_sprite_t *icon = &psq4_ui_sprite_wifi_ok;
+    psq4_gfx_coords_t origin = { TEST_CANVAS_W - icon->dim.w - 2, 2 };
+    psq4_gfx_bounds_t bounds;
+    PSQ4_CHECK_EQ(21, icon->dim.w);
+    PSQ4_CHECK_EQ(16, icon->dim.h);
+
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_render_rle_sprite(canvas, icon, &origin, &bounds));
+    PSQ4_CHECK_EQ(21 * 16 * 2, flush_all(canvas));
+
+    // Re-rendering, or replacing the icon, dirties nothing beyond it
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_render_rle_sprite(canvas, icon, &origin, &bounds));
+    PSQ4_CHECK_EQ(21 * 16 * 2, flush_all(canvas));
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_erase_rle_sprite(canvas, icon, TEST_BACKGROUND, &origin, &bounds));
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_render_rle_sprite(canvas, icon, &origin, &bounds));
+    PSQ4_CHECK_EQ(21 * 16 * 2, flush_all(canvas));
+}
+
+
+// Fills the table several times over with random rectangles, which
+// must all be flushed, but never at greater cost than their union
+static void test_merge_within_union(psq4_gfx_canvas_t *canvas)
+{
+    static uint8_t dirtied[TEST_CANVAS_H][TEST_CANVAS_W];
+    uint32_t seed = 1;
+    for (int trial = 0; trial < TEST_MERGE_TRIALS; trial++) {
+        psq4_gfx_bounds_t all = { TEST_CANVAS_W - 1, TEST_CANVAS_H - 1, 0, 0 };
+        memset(dirtied, 0, sizeof(dirtied));
+        for (int i = 0; i < TEST_MERGE_RECTS; i++) {
+            psq4_gfx_bounds_t rect;
+            seed = seed * 1664525 + 1013904223;
+            int x = (seed >> 8) % TEST_CANVAS_W;
+            int y = (seed >> 16) % TEST_CANVAS_H;
+            rect.x0 = x;
+            rect.y0 = y;
+            seed = seed * 1664525 + 1013904223;
+            x += (seed >> 8) % 24;
+            y += (seed >> 16) % 24;
+            rect.x1 = x < TEST_CANVAS_W ? x : TEST_CANVAS_W - 1;
+            rect.y1 = y < TEST_CANVAS_H ? y : TEST_CANVAS_H - 1;
+            psq4_gfx_fill_rect(canvas, (uint16_t) seed, &rect);
+            for (int y = rect.y0; y <= rect.y1; y++) {
+                memset(&dirtied[y][rect.x0], 1, rect.x1 - rect.x0 + 1);
+            }
+            if (rect.x0 < all.x0) all.x0 = rect.x0;
+            if (rect.y0 < all.y0) all.y0 = rect.y0;
+            if (rect.x1 > all.x1) all.x1 = rect.x1;
+            if (rect.y1 > all.y1) all.y1 = rect.y1;
+        }
+        PSQ4_CHECK(canvas->dirty_rect_count <= PSQ4_GFX_MAX_DIRTY_RECTS);
+        size_t bytes = flush_all(canvas);
+        PSQ4_CHECK(bytes <= (size_t) (all.x1 - all.x0 + 1) * (all.y1 - all.y0 + 1) * 2);
+        size_t missed = 0;
+        for (int y = 0; y < TEST_CANVAS_H; y++) {
+            for (int x = 0; x < TEST_CANVAS_W; x++) {
+                if (dirtied[y][x] && !flushed[y][x]) missed++;
+            }
+        }
+        PSQ4_CHECK_EQ(0, missed);
+    }
+}
+
+
+int main()
+{
+    psq4_gfx_canvas_t canvas;
+    psq4_gfx_dim_t dim = { TEST_CANVAS_W, TEST_CANVAS_H };
+    PSQ4_CHECK_EQ(ESP_OK, psq4_gfx_init(&canvas, &dim));
+    // The new canvas is dirty all over
+    PSQ4_CHECK_EQ(TEST_CANVAS_W * TEST_CANVAS_H * 2, flush_all(&canvas));
+    test_status_icon(&canvas);
+    test_merge_within_union(&canvas);
+    psq4_gfx_free(&canvas);
+    return PSQ4_TEST_RESULT();
+}
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The shim's semaphores stand in for FreeRTOS ones in every other host
+// test, so check that they block, time out and count as FreeRTOS does
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "psq4_test.h"
+
+
+static void test_mutex()
+{
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    PSQ4_CHECK(mutex != NULL);
+    PSQ4_CHECK_EQ(pdTRUE, xSemaphoreTake(mutex, 0));
+    PSQ4_CHECK_EQ(pdFALSE, xSemaphoreTake(mutex, 0));
+    PSQ4_CHECK_EQ(pdTRUE, xSemaphoreGive(mutex));
+    PSQ4_CHECK_EQ(pdFALSE, xSemaphoreGive(mutex));
+    PSQ4_CHECK_EQ(pdTRUE, xSemaphoreTake(mutex, portMAX_DELAY));
+    vSemaphoreDelete(mutex);
+}
+
+
+static void test_binary_semaphore_times_out()
+{
+    StaticSemaphore_t buffer;
+    SemaphoreHandle_t semaphore = xSemaphoreCreateBinaryStatic(&buffer);
+    PSQ4_CHECK(semaphore == &buffer);
+    TickType_t start = xTaskGetTickCount();
+    PSQ4_CHECK_EQ(pdFALSE, xSemaphoreTake(semaphore, 20));
+    PSQ4_CHECK(xTaskGetTickCount() - start >= 20);
+    PSQ4_CHECK_EQ(pdTRUE, xSemaphoreGive(semaphore));
+    PSQ4_CHECK_EQ(pdTRUE, xSemaphoreTake(semaphore, 20));
+    vSemaphoreDelete(semaphore);
+}
+
+
+static void test_ticks_are_milliseconds()
+{
+    TickType_t start = xTaskGetTickCount();
+    vTaskDelay(10);
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    PSQ4_CHECK(elapsed >= 10);
+    PSQ4_CHECK(elapsed < 1000);
+}
+
+
+int main()
+{
+    test_mutex();
+    test_binary_semaphore_times_out();
+    test_ticks_are_milliseconds();
+    return PSQ4_TEST_RESULT();
+}
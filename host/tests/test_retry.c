@@ -0,0 +1,201 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Simulates outages of a broker against psq4_retry, in virtual time,
+// checking the circuit breaker's transitions and the backoff's jitter
+
+#include <stdbool.h>
+#include <psq4_retry.h>
+#include "psq4_test.h"
+
+
+#define TEST_BASE_MS 1000
+#define TEST_CAP_MS 60000
+#define TEST_THRESHOLD 10
+#define TEST_OPEN_MS 300000
+#define TEST_JITTER_DRAWS 10000
+
+
+static uint64_t now_ms;
+static uint32_t seed = 1;
+static uint32_t fixed_random;
+static bool use_fixed_random;
+static int opened;
+static int closed;
+
+
+static void fake_sleep(uint32_t ms)
+{
+    now_ms += ms;
+}
+
+
+static uint32_t fake_random(void)
+{
+    if (use_fixed_random) return fixed_random;
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+
+static void fake_on_open(bool open)
+{
+    if (open) {
+        opened++;
+    } else {
+        closed++;
+    }
+}
+
+
+static const psq4_retry_policy_t policy = {
+    .base_ms = TEST_BASE_MS,
+    .cap_ms = TEST_CAP_MS,
+    .failure_threshold = TEST_THRESHOLD,
+    .open_ms = TEST_OPEN_MS,
+    .on_open = fake_on_open,
+    .random = fake_random,
+    .sleep = fake_sleep,
+};
+
+
+static uint32_t ceiling_after(uint32_t failures)
+{
+    uint64_t ceiling = (uint64_t) TEST_BASE_MS << (failures - 1);
+    return ceiling < TEST_CAP_MS ? (uint32_t) ceiling : TEST_CAP_MS;
+}
+
+
+// Every delay below the threshold lies within the doubling ceiling,
+// and the ceiling itself is reachable
+static void test_jitter_bounds()
+{
+    psq4_retry_t retry;
+    static const psq4_retry_policy_t unbroken = {
+        .base_ms = TEST_BASE_MS,
+        .cap_ms = TEST_CAP_MS,
+        .failure_threshold = 0,
+        .random = fake_random,
+        .sleep = fake_sleep,
+    };
+    for (uint32_t failures = 1; failures <= 12; failures++) {
+        uint32_t ceiling = ceiling_after(failures);
+        uint32_t highest = 0;
+        for (int draw = 0; draw < TEST_JITTER_DRAWS; draw++) {
+            psq4_retry_init(&retry, &unbroken);
+            uint32_t delay = 0;
+            for (uint32_t i = 0; i < failures; i++) delay = psq4_retry_failed(&retry);
+            PSQ4_CHECK(delay <= ceiling);
+            if (delay > highest) highest = delay;
+        }
+        // Full jitter spreads delays over the whole range
+        PSQ4_CHECK(highest > ceiling / 2);
+
+        use_fixed_random = true;
+        fixed_random = ceiling;
+        psq4_retry_init(&retry, &unbroken);
+        uint32_t delay = 0;
+        for (uint32_t i = 0; i < failures; i++) delay = psq4_retry_failed(&retry);
+        PSQ4_CHECK_EQ(ceiling, delay);
+        use_fixed_random = false;
+    }
+}
+
+
+// Drives the breaker through an outage that outlasts a rest: CLOSED,
+// OPEN at the threshold, HALF_OPEN for a trial that fails, OPEN again,
+// HALF_OPEN for a trial that succeeds, then CLOSED
+static void test_outage()
+{
+    psq4_retry_t retry;
+    now_ms = 0;
+    opened = 0;
+    closed = 0;
+    psq4_retry_init(&retry, &policy);
+    PSQ4_CHECK_EQ(PSQ4_RETRY_CLOSED, retry.state);
+
+    for (uint32_t i = 1; i < TEST_THRESHOLD; i++) {
+        uint64_t before = now_ms;
+        psq4_retry_backoff(&retry);
+        PSQ4_CHECK_EQ(PSQ4_RETRY_CLOSED, retry.state);
+        PSQ4_CHECK(now_ms - before <= ceiling_after(i));
+    }
+    PSQ4_CHECK_EQ(0, opened);
+
+    uint64_t before = now_ms;
+    psq4_retry_backoff(&retry);
+    PSQ4_CHECK_EQ(TEST_OPEN_MS, now_ms - before);
+    PSQ4_CHECK_EQ(1, opened);
+    // Having rested, the next attempt is the trial
+    PSQ4_CHECK_EQ(PSQ4_RETRY_HALF_OPEN, retry.state);
+
+    // A failed trial rests again, without notifying again
+    PSQ4_CHECK_EQ(TEST_OPEN_MS, psq4_retry_failed(&retry));
+    PSQ4_CHECK_EQ(PSQ4_RETRY_OPEN, retry.state);
+    PSQ4_CHECK_EQ(1, opened);
+    PSQ4_CHECK_EQ(0, closed);
+
+    before = now_ms;
+    psq4_retry_backoff(&retry);
+    PSQ4_CHECK_EQ(TEST_OPEN_MS, now_ms - before);
+    PSQ4_CHECK_EQ(PSQ4_RETRY_HALF_OPEN, retry.state);
+
+    psq4_retry_succeeded(&retry);
+    PSQ4_CHECK_EQ(PSQ4_RETRY_CLOSED, retry.state);
+    PSQ4_CHECK_EQ(0, retry.failures);
+    PSQ4_CHECK_EQ(1, opened);
+    PSQ4_CHECK_EQ(1, closed);
+
+    // Once closed, backoff starts again from the base
+    use_fixed_random = true;
+    fixed_random = UINT32_MAX;
+    PSQ4_CHECK(psq4_retry_failed(&retry) <= TEST_BASE_MS);
+    use_fixed_random = false;
+    psq4_retry_succeeded(&retry);
+    PSQ4_CHECK_EQ(1, closed);
+}
+
+
+// Short outages never open the circuit
+static void test_intermittent()
+{
+    psq4_retry_t retry;
+    opened = 0;
+    psq4_retry_init(&retry, &policy);
+    for (int outage = 0; outage < 100; outage++) {
+        for (uint32_t i = 1; i < TEST_THRESHOLD; i++) psq4_retry_backoff(&retry);
+        psq4_retry_succeeded(&retry);
+    }
+    PSQ4_CHECK_EQ(0, opened);
+    PSQ4_CHECK_EQ(PSQ4_RETRY_CLOSED, retry.state);
+}
+
+
+int main()
+{
+    test_jitter_bounds();
+    test_outage();
+    test_intermittent();
+    return PSQ4_TEST_RESULT();
+}
@@ -24,10 +24,15 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <sdkconfig.h>
 
 #include <psq4_aws_iot.h>
 #include <psq4_constants.h>
+#include <psq4_diagnostics.h>
+#include <psq4_filter_bench.h>
+#include <psq4_gfx_bench.h>
 #include <psq4_system.h>
+#include <psq4_rtos.h>
 #include <psq4_telemetry.h>
 #include <psq4_ui.h>
 
@@ -37,10 +42,19 @@ static psq4_ui_params_t ui_params;
 
 void app_main(void)
 {
+#if CONFIG_PSQ4_GFX_BENCH
+    psq4_gfx_bench_run();
+#endif
+#if CONFIG_PSQ4_FILTER_BENCH
+    psq4_filter_bench_run();
+#endif
     psq4_system_init();
     psq4_aws_iot_init();
     psq4_telemetry_init();
+#if CONFIG_PSQ4_DIAGNOSTICS
+    psq4_diagnostics_init();
+#endif
 
     ui_params.max_trans_size = PSQ4_SPI_MAX_TRANS_SIZE_BYTES;
-    xTaskCreate(&psq4_ui_task, "uiTask", 4096, &ui_params, 5, NULL);
+    PSQ4_TASK_CREATE(&psq4_ui_task, "uiTask", 4096, &ui_params, 5, NULL);
 }
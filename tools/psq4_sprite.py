@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2020 Michael Volk
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice, this permission notice, and the disclaimer below
+# shall be included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Generates psq4-ui sprite sources from PNG images.
+
+Usage:
+
+    tools/psq4_sprite.py wifi_ok.png wifi_ok -o components/psq4-ui/wifi_ok.c
+
+The PNG is converted to big-endian RGB/565 and run-length encoded row by row
+in the format documented alongside psq4_gfx_rle_sprite_t in psq4_gfx.h.
+Pixels with alpha below the threshold, or matching the --key color, become
+transparent SKIP runs.
+
+Only the standard library is used, so only non-interlaced 8-bit PNGs are
+supported (greyscale, RGB, palette, and their alpha variants).
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+
+RLE_SKIP = 0x00
+RLE_FILL = 0x40
+RLE_COPY = 0x80
+RLE_MAX_RUN = 64
+
+LICENSE = """/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Michael Volk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, this permission notice, and the disclaimer below
+ * shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+"""
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+
+def read_png(path):
+    """Returns (width, height, rows) where rows hold (r, g, b, a) tuples."""
+    with open(path, 'rb') as f:
+        blob = f.read()
+    if blob[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('%s is not a PNG file' % path)
+    pos = 8
+    idat = b''
+    palette = []
+    trns = b''
+    while pos < len(blob):
+        length, kind = struct.unpack('>I4s', blob[pos:pos + 8])
+        chunk = blob[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b'tRNS':
+            trns = chunk
+        elif kind == b'IDAT':
+            idat += chunk
+        elif kind == b'IEND':
+            break
+    if depth != 8 or interlace != 0:
+        raise ValueError('%s must be a non-interlaced 8-bit PNG' % path)
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    stride = width * channels
+    raw = zlib.decompress(idat)
+    rows = []
+    prev = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        filter_type = raw[start]
+        line = bytearray(raw[start + 1:start + 1 + stride])
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if filter_type == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif filter_type == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif filter_type == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif filter_type == 4:
+                line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        prev = line
+        row = []
+        for x in range(width):
+            px = line[x * channels:(x + 1) * channels]
+            if color_type == 0:
+                row.append((px[0], px[0], px[0], 255))
+            elif color_type == 2:
+                row.append((px[0], px[1], px[2], 255))
+            elif color_type == 3:
+                alpha = trns[px[0]] if px[0] < len(trns) else 255
+                row.append(palette[px[0]] + (alpha,))
+            elif color_type == 4:
+                row.append((px[0], px[0], px[0], px[1]))
+            else:
+                row.append(tuple(px))
+        rows.append(row)
+    return width, height, rows
+
+
+def rgb565(r, g, b):
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def encode_row(row):
+    """Run-length encodes a row of RGB/565 colors, None being transparent."""
+    out = []
+    x = 0
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:RLE_MAX_RUN]
+            del literal[:RLE_MAX_RUN]
+            out.append(RLE_COPY | (len(chunk) - 1))
+            for color in chunk:
+                out.extend((color >> 8, color & 0xFF))
+
+    while x < len(row):
+        run = 1
+        while x + run < len(row) and row[x + run] == row[x] and run < RLE_MAX_RUN:
+            run += 1
+        if row[x] is None:
+            flush_literal()
+            out.append(RLE_SKIP | (run - 1))
+        elif run >= 2:
+            flush_literal()
+            out.extend((RLE_FILL | (run - 1), row[x] >> 8, row[x] & 0xFF))
+        else:
+            literal.append(row[x])
+        x += run
+    flush_literal()
+    return out
+
+
+def render_source(name, width, height, rows):
+    """Returns the C source for a sprite named psq4_ui_sprite_<name>."""
+    encoded = [encode_row(row) for row in rows]
+    size = sum(len(row) for row in encoded)
+    lines = [LICENSE]
+    lines.append('#include "psq4_ui_sprites.h"')
+    lines.append('#include "psq4_gfx.h"')
+    lines.append('')
+    lines.append('static const psq4_gfx_dim_t dim = { %d, %d };' % (width, height))
+    lines.append('')
+    lines.append('// Run-length encoded, one row per line')
+    lines.append('static const uint8_t data[%d] = {' % size)
+    for i, row in enumerate(encoded):
+        text = ', '.join('0x%02X' % byte for byte in row)
+        lines.append('    ' + text + (',' if i < len(encoded) - 1 else ''))
+    lines.append('};')
+    lines.append('')
+    lines.append('const psq4_gfx_rle_sprite_t psq4_ui_sprite_%s = { data, dim };' % name)
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate a psq4-ui sprite source from a PNG image.')
+    parser.add_argument('png', help='source image')
+    parser.add_argument('name', help='sprite name, e.g. wifi_ok for psq4_ui_sprite_wifi_ok')
+    parser.add_argument('-o', '--output', help='output file (stdout by default)')
+    parser.add_argument('--alpha-threshold', type=int, default=128,
+                        help='pixels with alpha below this are transparent (default 128)')
+    parser.add_argument('--key', help='RRGGBB color treated as transparent, e.g. FFFFFF')
+    args = parser.parse_args()
+
+    width, height, pixels = read_png(args.png)
+    if width > 255 or height > 255:
+        raise ValueError('sprites are limited to 255 pixels in either dimension')
+    key = None
+    if args.key:
+        key = rgb565(*bytes.fromhex(args.key))
+    rows = [
+        [None if a < args.alpha_threshold else rgb565(r, g, b) for (r, g, b, a) in row]
+        for row in pixels
+    ]
+    rows = [[None if color == key else color for color in row] for row in rows]
+    source = render_source(args.name, width, height, rows)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(source)
+    else:
+        sys.stdout.write(source)
+
+
+if __name__ == '__main__':
+    main()
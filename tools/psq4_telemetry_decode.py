@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2020 Michael Volk
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice, this permission notice, and the disclaimer below
+# shall be included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Decodes delta-compressed Pipsqueak v4 telemetry payloads.
+
+Usage:
+
+    tools/psq4_telemetry_decode.py payload.bin
+    tools/psq4_telemetry_decode.py --hex 0102000000...
+
+Prints the samples as the JSON array that the JSON payload format would have
+published, with temperatures in degrees C. The format is documented alongside
+psq4_delta_encoder_t in psq4_delta.h.
+"""
+
+import argparse
+import json
+import sys
+
+
+VERSION = 1
+
+
+def read_varint(payload, pos):
+    """Returns (value, next position) for the varint at pos."""
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(payload):
+            raise ValueError('payload ends inside a varint')
+        byte = payload[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_int32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def decode(payload):
+    """Returns a list of samples, dicts of timestamp, sensor and temperature."""
+    if not payload or payload[0] != VERSION:
+        raise ValueError('not a version %d delta payload' % VERSION)
+    count, pos = read_varint(payload, 1)
+    samples = []
+    timestamp = 0
+    delta = 0
+    last_values = {}
+    for i in range(count):
+        sensor, pos = read_varint(payload, pos)
+        value, pos = read_varint(payload, pos)
+        if i == 0:
+            timestamp = value
+        else:
+            if i == 1:
+                delta = to_int32(unzigzag(value))
+            else:
+                delta = to_int32(delta + unzigzag(value))
+            timestamp = (timestamp + delta) & 0xFFFFFFFF
+        value, pos = read_varint(payload, pos)
+        centi_degrees = unzigzag(value)
+        if sensor in last_values:
+            centi_degrees = to_int32(last_values[sensor] + centi_degrees)
+        last_values[sensor] = centi_degrees
+        samples.append({
+            'timestamp': timestamp,
+            'sensor': sensor,
+            'temperature': centi_degrees / 100,
+        })
+    if pos != len(payload):
+        raise ValueError('%d bytes follow the last sample' % (len(payload) - pos))
+    return samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a delta-compressed telemetry payload.')
+    parser.add_argument('payload', help='file holding the payload, or hex digits with --hex')
+    parser.add_argument('--hex', action='store_true', help='the payload is given as hex digits')
+    args = parser.parse_args()
+
+    if args.hex:
+        payload = bytes.fromhex(args.payload)
+    else:
+        with open(args.payload, 'rb') as f:
+            payload = f.read()
+    json.dump(decode(payload), sys.stdout, indent=2)
+    sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+    main()
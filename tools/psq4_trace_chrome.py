@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2020 Michael Volk
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice, this permission notice, and the disclaimer below
+# shall be included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Converts a Pipsqueak v4 trace dump to Chrome trace JSON.
+
+Usage:
+
+    tools/psq4_trace_chrome.py monitor.log -o trace.json
+
+where monitor.log is console output captured after typing "trace" and Enter
+into the serial console, for instance by a terminal program's logging. Open the result in chrome://tracing or https://ui.perfetto.dev. Only the last
+dump in the log is converted; other output is ignored. The dump format is
+written by psq4_trace_dump() in psq4_trace.c.
+
+Cycle counts are converted to microseconds since boot, walking back from a
+reference taken on each core during the dump. Cycle counters wrap every
+2^32 cycles (under 18 seconds at 240 MHz), so gaps of that long between
+consecutive events on a core are under-measured by whole wraps.
+"""
+
+import argparse
+import json
+import sys
+
+
+PREFIX = 'psq4-trace'
+
+
+def parse_dump(lines):
+    """Returns (cpu_hz, {core: (ref_ccount, ref_us)}, [events]) of the last dump."""
+    dump = None
+    complete = None
+    for line in lines:
+        # Console output may carry color codes or other noise before the prefix
+        start = line.find(PREFIX + '\t')
+        if start < 0:
+            continue
+        fields = line[start:].rstrip('\r\n').split('\t')
+        kind = fields[1]
+        if kind == 'begin':
+            dump = (int(fields[2]), {}, [])
+        elif dump is None:
+            continue
+        elif kind == 'core':
+            dump[1][int(fields[2])] = (int(fields[3]), int(fields[4]))
+        elif kind == 'event':
+            core, ccount, phase, task, name, arg = fields[2:8]
+            dump[2].append({
+                'core': int(core),
+                'ccount': int(ccount),
+                'phase': phase,
+                'task': task,
+                'name': name,
+                'arg': int(arg),
+            })
+        elif kind == 'end':
+            complete = dump
+    if dump is None:
+        raise ValueError('no trace dump found')
+    if complete is not dump:
+        raise ValueError('the last trace dump is incomplete')
+    return complete
+
+
+def timestamp_events(cpu_hz, references, events):
+    """Sets each event's ts, in microseconds since boot."""
+    cycles_per_us = cpu_hz / 1e6
+    for core, (ref_ccount, ref_us) in references.items():
+        elapsed = 0
+        later = ref_ccount
+        for event in reversed([e for e in events if e['core'] == core]):
+            elapsed += (later - event['ccount']) & 0xFFFFFFFF
+            later = event['ccount']
+            event['ts'] = ref_us - elapsed / cycles_per_us
+
+
+def to_chrome(events):
+    """Returns a Chrome trace event list, one thread per task."""
+    tids = {}
+    out = []
+    for event in sorted(events, key=lambda e: e['ts']):
+        tid = tids.setdefault(event['task'], len(tids) + 1)
+        record = {
+            'name': event['name'],
+            'ph': event['phase'],
+            'ts': round(event['ts'], 3),
+            'pid': 1,
+            'tid': tid,
+            'args': {'core': event['core']},
+        }
+        if event['phase'] in 'be':
+            record['cat'] = 'psq4'
+            record['id'] = event['arg']
+        elif event['phase'] == 'i':
+            record['s'] = 't'
+            record['args']['arg'] = event['arg']
+        out.append(record)
+    for task, tid in tids.items():
+        out.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': tid, 'args': {'name': task}})
+    out.append({'name': 'process_name', 'ph': 'M', 'pid': 1, 'args': {'name': 'pipsqueak'}})
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a trace dump to Chrome trace JSON.')
+    parser.add_argument('log', nargs='?', help='captured console output (stdin by default)')
+    parser.add_argument('-o', '--output', help='output file (stdout by default)')
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors='replace') as f:
+            cpu_hz, references, events = parse_dump(f)
+    else:
+        cpu_hz, references, events = parse_dump(sys.stdin)
+    timestamp_events(cpu_hz, references, events)
+    trace = json.dumps({'traceEvents': to_chrome(events), 'displayTimeUnit': 'ms'}, indent=1)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(trace + '\n')
+    else:
+        sys.stdout.write(trace + '\n')
+
+
+if __name__ == '__main__':
+    main()